@@ -39,6 +39,46 @@ InChannelFadeUp = 1
 OutChannelXFade = 0
 OutChannelFadeUp = 1
 
+### PREDICTION
+#
+# The processor applies a fade some time after the fader moves, so fast cuts can land late.
+# With prediction enabled, a moving fader is sent as where it will be when the command takes effect.
+#
+# LatencyPercent = How much of the measured round-trip time to look ahead by. 50 is the one-way time.
+# MaxLeadMillis = The most to look ahead by, however slow the link gets.
+
+[Prediction]
+
+Enabled = No
+LatencyPercent = 50
+MaxLeadMillis = 60
+
+### TRANSITION
+#
+# An auto transition runs the crossfade to the other source on its own.
+# Take one by double-tapping a tap button, from the Mix Mode menu, or by OSC to /dvimxr/take
+# So a double-tap doesn't cut first, a single tap cuts once the double-tap window has passed, a third of a second or so
+#
+# DurationMillis = How long the transition takes. OSC can give its own, in seconds, as /dvimxr/take 1.5
+# Curve = Name of the curve to transition with, from the curves below
+
+[Transition]
+
+DurationMillis = 2000
+Curve = S-Curve
+
+### DISPLAY
+#
+# FrameRate = How many times a second the OLED is redrawn at most, up to 100.
+#  Status text from network input is redrawn at most ten times a second, whatever this is.
+# Meters = Replace the logo with live A and B fade levels, and graphs of the processor link's
+#  round-trip time and failed commands. The graphs run right to left over the last 15 seconds.
+
+[Display]
+
+FrameRate = 30
+Meters = Yes
+
 ### KEYS
 #
 # Name = What is shown in menu
@@ -91,6 +131,38 @@ MaxV = 35
 
 # Edit the above, or add your own keys here, up to Key99
 
+### CURVES
+#
+# Response curves for the crossfader and fade-up, selected in the Mix Mode menu.
+# These replace the built-in S-Curve, Log and Cut at 10% curves. Linear is always available.
+#
+# CurveNName = What is shown in menu
+# CurveNFader = XFade, FadeUp or Both
+# CurveNShape = Linear, S, Log or Cut. Cut also takes CurveNThreshold, in percent.
+# CurveNPoints = Instead of a shape, up to 16 input:output percent pairs, straight lines between.
+#  Give an input twice to step, ie. 0:0, 10:0, 10:100, 100:100 cuts at 10%
+
+[Curves]
+
+Curve1Name = S-Curve
+Curve1Fader = Both
+Curve1Shape = S
+
+Curve2Name = Log
+Curve2Fader = FadeUp
+Curve2Shape = Log
+
+Curve3Name = Cut at 10%
+Curve3Fader = XFade
+Curve3Shape = Cut
+Curve3Threshold = 10
+
+Curve4Name = Slow Start
+Curve4Fader = Both
+Curve4Points = 0:0, 50:20, 100:100
+
+# Edit the above, or add your own curves here, up to Curve99
+
 ### RESOLUTIONS
 #
 # Name = What is shown in menu
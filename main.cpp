@@ -55,15 +55,26 @@
 
 #include "spk_tvone_mbed.h"
 #include "spk_utils.h"
+#include "spk_input.h"
 #include "spk_mRotaryEncoder.h"
 #include "spk_oled_ssd1305.h"
 #include "spk_oled_gfx.h"
+#include "spk_oled_scheduler.h"
 #include "spk_settings.h"
+#include "spk_fader_sampler.h"
+#include "spk_mix_engine.h"
+#include "spk_auto_transition.h"
+#include "spk_tvone_pacing.h"
+#include "spk_tvone_frame.h"
+#include "spk_tvone_sim.h"
+#include "spk_tvone_async.h"
+#include "spk_tvone_cache.h"
+#include "spk_tvone_queue.h"
+#include "spk_oled_meters.h"
 #include "EthernetNetIf.h"
 #include "mbedOSC.h"
 #include "DmxArtNet.h"
 #include "DMX.h"
-#include "filter.h"
 
 #define kSPKDFSoftwareVersion "30"
 
@@ -71,6 +82,8 @@
 
 #define kMBED_AIN_XFADE     p20
 #define kMBED_AIN_FADEUP    p19
+#define kMBED_ADC_XFADE     5   // AD0.5 is p20
+#define kMBED_ADC_FADEUP    4   // AD0.4 is p19
 #define kMBED_DIN_TAP_L     p24
 #define kMBED_DIN_TAP_R     p23
 #define kMBED_ENC_SW        p15
@@ -98,6 +111,17 @@
 #define kCommsStatusLine 6
 #define kTVOneStatusLine 7
 #define kTVOneStatusMessageHoldTime 5
+#define kCommsStatusIntervalMillis 100
+
+// TVONE REGISTER CACHE
+
+#define kTVOneCacheStaleMillis 60000
+#define kTVOneCacheVerifyMillis 2000
+
+#define kFadeHysteresisPercent 0.3 // How far past a percent the mix has to move before it changes
+#define kEncoderAccelerationFadeCurve   3  // Most steps per detent when turned fast, for each handler's range
+#define kEncoderAccelerationKeyer       12
+#define kEncoderAccelerationDuration    20
 
 // 8.3 format filename only, no subdirs
 #define kSPKDFSettingsFilename "SPKDF.ini"
@@ -110,6 +134,16 @@
 //Serial *debug = new Serial(USBTX, USBRX); // For debugging via USB serial
 Serial *debug = NULL; // For release (no debugging)
 
+// Uncomment to build the link benchmark, against a simulated processor rather than the real one. Not for release.
+//#define kTVOneBenchmark
+
+// Uncomment to time the mix engine against the float formulas it replaced, on startup over debug. Not for release.
+//#define kSPKMixEngineBenchmark
+
+#ifdef kTVOneBenchmark
+SPKTVOneSim *tvOneSim = new SPKTVOneSim(15, 5, 1); // Simulated processor: latency ms, jitter ms, drop %. Benchmarks the link on startup.
+#endif
+
 //// SOFT RESET
 
 extern "C" void mbed_reset();
@@ -117,16 +151,17 @@ extern "C" void mbed_reset();
 //// mBED PIN ASSIGNMENTS
 
 // Inputs
-AnalogIn xFadeAIN(kMBED_AIN_XFADE);    
+AnalogIn xFadeAIN(kMBED_AIN_XFADE);     // These set the pins up as analogue inputs, faderSampler reads them
 AnalogIn fadeUpAIN(kMBED_AIN_FADEUP);
-DigitalIn tapLeftDIN(kMBED_DIN_TAP_L);
-DigitalIn tapRightDIN(kMBED_DIN_TAP_R);
-medianFilter xFadeFilter(9);
-medianFilter fadeUpFilter(9);
+SPKInputQueue inputQueue; // Everything below pushes timestamped events from its interrupts, drained by processInputEvents
+SPKInputPin tapLeftPin(kMBED_DIN_TAP_L, &inputQueue, SPKInputQueue::inputTapLeft);
+SPKInputPin tapRightPin(kMBED_DIN_TAP_R, &inputQueue, SPKInputQueue::inputTapRight);
+SPKFaderSampler faderSampler(kMBED_ADC_XFADE, kMBED_ADC_FADEUP); // Sampler index 0 is xFade, 1 fadeUp
+SPKFaderPredictor faderPredictor(&faderSampler);
 
 SPKRotaryEncoder menuEnc(kMBED_ENC_A, kMBED_ENC_B, kMBED_ENC_SW);
 
-DigitalIn rj45ModeDIN(kMBED_DIN_ETHLO_DMXHI);
+SPKInputPin rj45ModePin(kMBED_DIN_ETHLO_DMXHI, &inputQueue, SPKInputQueue::inputRJ45Mode, false);
 
 // Outputs
 PwmOut fadeAPO(LED1);
@@ -136,11 +171,36 @@ DigitalOut dmxDirectionDOUT(kMBED_DOUT_RS485_TXHI_RXLO);
 
 // SPKTVOne(PinName txPin, PinName rxPin, PinName signWritePin, PinName signErrorPin, Serial *debugSerial)
 SPKTVOne tvOne(kMBED_RS232_TTLTX, kMBED_RS232_TTLRX, LED3, LED4, debug);
+SPKTVOnePacing tvOnePacing(&tvOne);
+SPKTVOneAsync tvOneAsync(kMBED_RS232_TTLTX, kMBED_RS232_TTLRX, debug);
+SPKTVOneCache tvOneCache(&tvOne, kTVOneCacheStaleMillis, kTVOneCacheVerifyMillis, debug);
+SPKTVOneQueue tvOneQueue(&tvOneCache);
 
 // SPKDisplay(PinName mosi, PinName clk, PinName cs, PinName dc, PinName res, Serial *debugSerial = NULL);
 SPKDisplay screen(kMBED_OLED_MOSI, kMBED_OLED_SCK, kMBED_OLED_CS, kMBED_OLED_DC, kMBED_OLED_RES, debug);
+SPKDisplayScheduler screenScheduler(&screen);
+SPKDisplayMeters screenMeters(&screen, &tvOnePacing);
 SPKMessageHold tvOneStatusMessage;
 
+// SPKTVOne polls the UART itself, so anything in flight on the async link has to finish first
+SPKTVOne& tvOneLibrary()
+{
+    tvOneAsync.release();
+    return tvOne;
+}
+
+// Asked for on every housekeeping pass, so only go to the processor until we know
+int tvOneProcessorVersion()
+{
+    static int version = -1;
+#ifdef kTVOneBenchmark
+    if (version == -1) version = 423;
+#else
+    if (version == -1) version = tvOneLibrary().getProcessorType().version;
+#endif
+    return version;
+}
+
 // Saved Settings
 SPKSettings settings;
 
@@ -152,12 +212,18 @@ SPKMenu resolutionMenu;
 SPKMenu mixModeMenu;
 SPKMenu mixModeAdditiveMenu;
 SPKMenu mixModeUpdateKeyMenu; 
+SPKMenu mixModeTransitionMenu;
+SPKMenu mixModePredictionMenu;
 enum { mixBlend, mixAdditive, mixKeyLeft, mixKeyRight };
 int mixKeyPresetStartIndex = 100; // need this hard coded as mixBlend and mixAdditive are now combined into the same menu item
+int mixCurveStartIndex = 200; // Then two items per curve, one per fader
+int xFadeCurveIndex = 0; // Into settings' fader curves, 0 is linear
+int fadeUpCurveIndex = 0;
 int mixKeyWindow = kTV1WindowIDA; // The window we've last used to key
 int mixMode = mixBlend; // Start with safe mix mode, and test to get out of it. Safe mode will work with inputs missing and without hold frames.
 int mixModeOld = mixMode;
 float fadeCurve = 0.0f; // 0 = "X", ie. as per blend, 1 = "/\", ie. as per additive  <-- pictograms!
+SPKMixEngine mixEngine; // Holds the fade curve, so set it there too
 
 SPKMenu commsMenu;
 enum { commsNone, commsOSC, commsArtNet, commsDMXIn, commsDMXOut};
@@ -184,23 +250,51 @@ DmxArtNet *artNet = NULL;
 DMX *dmx = NULL;
 
 // Fade logic constants
-const float xFadeTolerance = 0.05;
-const float fadeUpTolerance = 0.05;
+const int32_t xFadeTolerance = 3277; // 0.05 of 0-65536
+const int32_t fadeUpTolerance = 3277;
 
 // A&B Fade as resolved percent
 int fadeAPercent = 0;
 int fadeBPercent = 0;
-int oldFadeAPercent = 0;
-int oldFadeBPercent = 0;
+SPKPercentHysteresis fadeAHysteresis(kFadeHysteresisPercent);
+SPKPercentHysteresis fadeBHysteresis(kFadeHysteresisPercent);
 
 // Tap button states
 bool tapLeftWasFirstPressed = false;
+bool tapLeftState = false;
+bool tapRightState = false;
+bool tapLeftTapped = false; // Pressed since processMix last looked, however briefly
+bool tapRightTapped = false;
+bool tapLeftPending = false; // Pressed, but held back until it can't be the first of a double-tap
+bool tapRightPending = false;
+bool tapLeftDoubled = false; // Held down as the second of a double-tap, so not a cut
+bool tapRightDoubled = false;
+uint32_t tapLeftPressedMicros = 0; // On inputQueue's clock
+uint32_t tapRightPressedMicros = 0;
+
+// Encoder and RJ45 state, as of the last input events
+int menuChangePending = 0;
+bool menuPressed = false;
+int rj45ModeInput = -1;
+
+// How long input events waited to be handled, reported on debug when the worst gets worse
+int inputLatencyMaxMicros = 0;
+int inputLatencyMeanMicros = 0;
+int inputOverflowsReported = 0;
+
+// Auto transition, taken by double-tap, menu or OSC. Holds its end until the crossfader is moved.
+SPKAutoTransition autoTransition;
+bool autoTransitionRequested = false;
+int autoTransitionRequestedMillis = -1; // From OSC, otherwise the settings' duration
+int32_t autoTransitionFaderStart = 0;
+int32_t autoTransitionTapTo = -1; // The side double-tapped, -1 if not taken by double-tap
+int32_t mixXFade = 0; // The crossfade last resolved, 0-65536
 
 // Comms In fade state
 float commsXFade = -1;
 float commsFadeUp = -1;
-float oldXFade = 0;
-float oldFadeUp = 0;
+int32_t oldXFade = 0; // 0-65536
+int32_t oldFadeUp = 0;
 bool  commsInActive = false;
 
 // TVOne input sources stable flag
@@ -251,6 +345,19 @@ bool processOSCIn()
                         statusMessage += buffer;
                     }
             }
+            else if (!strcmp( receiveMessage.getSubAddress() , "take" ))
+            {
+                autoTransitionRequested = true;
+                autoTransitionRequestedMillis = -1;
+                
+                if (receiveMessage.getArgNum() == 1)
+                    if (receiveMessage.getTypeTag(0) == 'f')
+                    {
+                        autoTransitionRequestedMillis = receiveMessage.getArgFloat(0) * 1000;
+                    }
+                
+                statusMessage += "/take";
+            }
             else if (!strcmp( receiveMessage.getSubAddress() , "xFadeFadeUp" ))
             {
                 if (receiveMessage.getArgNum() == 2)
@@ -278,8 +385,7 @@ bool processOSCIn()
             statusMessage += " - Ignoring";
         }
         
-        screen.clearBufferRow(kCommsStatusLine);
-        screen.textToBuffer(statusMessage, kCommsStatusLine);
+        screenScheduler.setText(kCommsStatusLine, statusMessage);
     
         if (debug) debug->printf("%s \r\n", statusMessage.c_str());
     }
@@ -295,8 +401,7 @@ void processOSCOut(const float &xFade, const float &fadeUp)
     
     char statusMessageBuffer[kStringBufferLength];
     snprintf(statusMessageBuffer, kStringBufferLength, "OSC Out: xF %.2f fUp %.2f", xFade, fadeUp);
-    screen.clearBufferRow(kCommsStatusLine);
-    screen.textToBuffer(statusMessageBuffer, kCommsStatusLine);
+    screenScheduler.setText(kCommsStatusLine, statusMessageBuffer);
 
     if (debug) debug->printf(statusMessageBuffer);
 }
@@ -313,8 +418,7 @@ bool processArtNetIn()
     
         char statusMessageBuffer[kStringBufferLength];
         snprintf(statusMessageBuffer, kStringBufferLength, "A'Net In: xF%3i fUp %3i", xFadeDMX, fadeUpDMX);
-        screen.clearBufferRow(kCommsStatusLine);
-        screen.textToBuffer(statusMessageBuffer, kCommsStatusLine);
+        screenScheduler.setText(kCommsStatusLine, statusMessageBuffer);
     
         if (debug) debug->printf("ArtNet activity");
         
@@ -344,8 +448,7 @@ void processArtNetOut(const float &xFade, const float &fadeUp)
 
     char statusMessageBuffer[kStringBufferLength];
     snprintf(statusMessageBuffer, kStringBufferLength, "A'Net Out: xF%3i fUp %3i", xFadeDMX, fadeUpDMX);
-    screen.clearBufferRow(kCommsStatusLine);
-    screen.textToBuffer(statusMessageBuffer, kCommsStatusLine);
+    screenScheduler.setText(kCommsStatusLine, statusMessageBuffer);
 
     if (debug) debug->printf(statusMessageBuffer);
 }
@@ -362,8 +465,7 @@ bool processDMXIn()
     
         char statusMessageBuffer[kStringBufferLength];
         snprintf(statusMessageBuffer, kStringBufferLength, "DMX In: xF %3i fUp %3i", xFadeDMX, fadeUpDMX);
-        screen.clearBufferRow(kCommsStatusLine);
-        screen.textToBuffer(statusMessageBuffer, kCommsStatusLine);
+        screenScheduler.setText(kCommsStatusLine, statusMessageBuffer);
     
         if (debug) debug->printf(statusMessageBuffer);
         
@@ -383,42 +485,329 @@ void processDMXOut(const float &xFade, const float &fadeUp)
     
     char statusMessageBuffer[kStringBufferLength];
     snprintf(statusMessageBuffer, kStringBufferLength, "DMX Out: xF %3i fUp %3i", xFadeDMX, fadeUpDMX);
-    screen.clearBufferRow(kCommsStatusLine);
-    screen.textToBuffer(statusMessageBuffer, kCommsStatusLine);
+    screenScheduler.setText(kCommsStatusLine, statusMessageBuffer);
 
     if (debug) debug->printf(statusMessageBuffer);
 }
 
-inline float fadeCalc (const float AIN, const float tolerance) 
+// Position and tolerance as 0-65536
+inline int32_t fadeCalc (const int32_t AIN, const int32_t tolerance) 
 {
-    float pos ;
+    int32_t pos ;
     if (AIN < tolerance) pos = 0;
-    else if (AIN > 1.0 - tolerance) pos = 1;
-    else pos = (AIN - tolerance) / (1 - 2*tolerance);
-    if (debug && false) debug->printf("fadeCalc in: %f out: %f \r\n", AIN, pos);
+    else if (AIN > kSPKMixEngineOne - tolerance) pos = kSPKMixEngineOne;
+    else pos = uint32_t(AIN - tolerance) * kSPKMixEngineOne / uint32_t(kSPKMixEngineOne - 2*tolerance);
+    if (debug && false) debug->printf("fadeCalc in: %i out: %i \r\n", AIN, pos);
     return pos;
 }
 
-bool handleTVOneSources()
+// From the crossfade as it is to the other source, or for a double-tap, to the side tapped.
+// Each step is a fade level for both windows, so steps come at half the rate the link takes commands.
+void takeAutoTransition(int32_t faderXFade)
 {
-    static int notOKCounter = 0;
+    int32_t from = mixXFade;
+    int32_t to = (mixXFade < kSPKMixEngineOne/2) ? kSPKMixEngineOne : 0;
+    if (autoTransitionTapTo >= 0)
+    {
+        to = autoTransitionTapTo;
+        autoTransitionTapTo = -1;
+    }
     
-    bool ok = true;
+    int durationMillis = (autoTransitionRequestedMillis > 0) ? autoTransitionRequestedMillis : settings.transition.durationMillis;
+    int curveIndex = settings.faderCurveIndex(settings.transition.curveName);
+    
+    autoTransition.start(from, to, durationMillis, tvOnePacing.commandPeriodMillis() * 2, &settings.faderCurve(curveIndex));
+    autoTransitionFaderStart = faderXFade;
+    autoTransitionRequestedMillis = -1;
+    
+    if (debug) debug->printf("Auto transition to %i over %ims \r\n", to, durationMillis);
+}
 
-    int32_t payload = 0;
+// Drains the input events the interrupts have queued into the state the rest of the program acts on.
+// The main loop calls this once per pass, and bulk work between chunks so taps still cut. Menus only act on it in the main loop.
+void processInputEvents()
+{
+    tapLeftPin.poll();
+    tapRightPin.poll();
+    rj45ModePin.poll();
     
-    ok = ok && tvOne.readCommand(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, payload);
-    bool RGB1 = (payload == 1);    
+    uint32_t now = inputQueue.micros();
+    
+    int latencyMaxWas = inputLatencyMaxMicros;
+    
+    SPKInputQueue::eventType event;
+    while (inputQueue.pop(event))
+    {
+        int latency = now - event.micros;
+        if (latency > inputLatencyMaxMicros) inputLatencyMaxMicros = latency;
+        inputLatencyMeanMicros += (latency - inputLatencyMeanMicros) >> 3;
+        
+        switch (event.source)
+        {
+            case SPKInputQueue::inputTapLeft:
+                tapLeftState = event.value;
+                if (event.value) { tapLeftPending = true; tapLeftPressedMicros = event.micros; }
+                else tapLeftDoubled = false;
+                break;
+            case SPKInputQueue::inputTapRight:
+                tapRightState = event.value;
+                if (event.value) { tapRightPending = true; tapRightPressedMicros = event.micros; }
+                else tapRightDoubled = false;
+                break;
+            case SPKInputQueue::inputEncoderTurn:
+                // Turning after a press is ignored until the press is actioned
+                if (!menuPressed) menuChangePending += event.value;
+                break;
+            case SPKInputQueue::inputEncoderPress:
+                menuPressed = true;
+                break;
+            case SPKInputQueue::inputRJ45Mode:
+                rj45ModeInput = event.value ? rj45DMX : rj45Ethernet;
+                break;
+        }
+        
+        // A double-tap takes an auto transition, and neither of its presses cuts
+        if ((event.source == SPKInputQueue::inputTapLeft || event.source == SPKInputQueue::inputTapRight) && event.value)
+        {
+            if (autoTransition.tap(event.micros))
+            {
+                bool left = (event.source == SPKInputQueue::inputTapLeft);
+                autoTransitionRequested = true;
+                autoTransitionTapTo = left ? 0 : kSPKMixEngineOne;
+                tapLeftPending = false;
+                tapRightPending = false;
+                if (left) tapLeftDoubled = true;
+                else tapRightDoubled = true;
+            }
+        }
+    }
+    
+    // A single tap cuts once the double-tap window has passed without a second, taking over from any transition.
+    // Signed, as a press queued after now was taken is in the future.
+    const int32_t doubleTapMicros = kAutoTransitionDoubleTapMillis * 1000;
+    if (tapLeftPending && int32_t(now - tapLeftPressedMicros) >= doubleTapMicros)
+    {
+        tapLeftPending = false;
+        tapLeftTapped = true;
+        autoTransition.cancel();
+    }
+    if (tapRightPending && int32_t(now - tapRightPressedMicros) >= doubleTapMicros)
+    {
+        tapRightPending = false;
+        tapRightTapped = true;
+        autoTransition.cancel();
+    }
+    
+    if (debug)
+    {
+        if (inputLatencyMaxMicros > latencyMaxWas) debug->printf("Input latency: max %ius, mean %ius \r\n", inputLatencyMaxMicros, inputLatencyMeanMicros);
+        
+        // Only what's been lost since last reported, as the count never resets
+        int overflows = inputQueue.overflowCount();
+        if (overflows != inputOverflowsReported) debug->printf("Input events lost: %i, %i in all \r\n", overflows - inputOverflowsReported, overflows);
+        inputOverflowsReported = overflows;
+    }
+}
+
+// Reads the control surface, and any network control, and queues the resulting fade levels for the TVOne.
+// As well as every pass of the main loop, bulk work calls this between chunks so the faders stay live throughout.
+bool processMix(float &xFade, float &fadeUp)
+{
+    bool updateFade = false;
+    
+    // Positions as 0-65536, the mix is all integer maths
+    int32_t xFadeQ16 = 0;
+    int32_t fadeUpQ16 = kSPKMixEngineOne;
+    
+    //// TASK: Process control surface
+    
+    // Get new states of tap buttons, as processInputEvents left them.
+    // A tap too short to span two passes still counts as pressed for this one, so the cut goes out on the next link slot.
+    // A press only counts once it can't be the first of a double-tap, and the second of one never does.
+    const bool tapLeft = tapLeftTapped || (tapLeftState && !tapLeftPending && !tapLeftDoubled);
+    const bool tapRight = tapRightTapped || (tapRightState && !tapRightPending && !tapRightDoubled);
+    tapLeftTapped = false;
+    tapRightTapped = false;
+    
+    // By when they were pressed, not which poll saw them first
+    tapLeftWasFirstPressed = int32_t(tapRightPressedMicros - tapLeftPressedMicros) > 0;
+    
+    // The faders are sampled and filtered in the background at a fixed rate, so this is just the latest.
+    // With prediction on, it's where they'll be by the time the processor applies the fade.
+    int leadMillis = 0;
+    if (settings.prediction.enabled)
+    {
+        leadMillis = tvOnePacing.smoothedRTTMillis() * settings.prediction.latencyPercent / 100;
+        if (leadMillis > settings.prediction.maxLeadMillis) leadMillis = settings.prediction.maxLeadMillis;
+    }
+    const int32_t xFadeAINCached = settings.prediction.enabled ? faderPredictor.position(0, leadMillis) : faderSampler.positionQ16(0);
+    const int32_t fadeUpAINCached = settings.prediction.enabled ? faderPredictor.position(1, leadMillis) : faderSampler.positionQ16(1);
+    
+    // When a tap is depressed, we can ignore any move of the crossfader but not fade to black
+    if (tapLeft || tapRight) 
+    {
+        // If both are pressed, take to the one that is new, ie. not the first pressed.
+        if (tapLeft && tapRight) 
+        {
+            xFadeQ16 = tapLeftWasFirstPressed ? kSPKMixEngineOne : 0;
+        }
+        // If just one is pressed, take to that
+        else if (tapLeft) 
+        {
+            xFadeQ16 = 0;
+        }
+        else if (tapRight) 
+        {
+            xFadeQ16 = kSPKMixEngineOne;
+        }
+    }
+    
+    const int32_t faderXFade = kSPKMixEngineOne - fadeCalc(xFadeAINCached, xFadeTolerance);
+    if (!tapLeft && !tapRight) xFadeQ16 = faderXFade;
+
+    fadeUpQ16 = kSPKMixEngineOne - fadeCalc(fadeUpAINCached, fadeUpTolerance);
+    
+    // Response curves are tables compiled when the settings loaded
+    xFadeQ16 = settings.faderCurve(xFadeCurveIndex).apply(xFadeQ16);
+    fadeUpQ16 = settings.faderCurve(fadeUpCurveIndex).apply(fadeUpQ16);
+    
+    //// TASK: Auto transition
+    
+    if (autoTransitionRequested)
+    {
+        autoTransitionRequested = false;
+        takeAutoTransition(faderXFade);
+    }
+    
+    if (autoTransition.isActive())
+    {
+        // Moving the crossfader takes back over, as with comms in
+        if (abs(faderXFade - autoTransitionFaderStart) > kSPKMixEngineOne / 10) autoTransition.cancel();
+        else xFadeQ16 = autoTransition.position();
+    }
+
+    //// TASK: Process Network Comms In, allowing hands-on controls to override
+    if ((commsMode == commsOSC) || (commsMode == commsArtNet) || (commsMode == commsDMXIn))
+    {
+        bool commsIn = false;
+
+        switch (commsMode)
+        {
+            case commsOSC:      commsIn = processOSCIn(); break;
+            case commsArtNet:   commsIn = processArtNetIn(); break;
+            case commsDMXIn:    commsIn = processDMXIn(); break;
+        }
+    
+        if (commsIn)
+        {
+            // Store hands-on control positions to compare for change later
+            commsInActive = true;
+            oldXFade = xFadeQ16;
+            oldFadeUp = fadeUpQ16;
+        }
+        else if (commsInActive)
+        {
+            // If no comms in update this loop, hold to the last unless hands-on controls have moved significantly
+            const int32_t threshold = kSPKMixEngineOne / 10;
+            bool movement = (abs(oldXFade-xFadeQ16) > threshold) || (abs(oldFadeUp-fadeUpQ16) > threshold);
+            if (movement) 
+            {   
+                commsInActive = false;
+                commsXFade = -1;
+                commsFadeUp = -1;
+            }
+        }
+    
+        if (commsInActive)
+        {
+            if (commsXFade >= 0)    xFadeQ16 = int32_t(commsXFade * kSPKMixEngineOne + 0.5f);
+            if (commsFadeUp >= 0)   fadeUpQ16 = int32_t(commsFadeUp * kSPKMixEngineOne + 0.5f);
+            if (xFadeQ16 > kSPKMixEngineOne)    xFadeQ16 = kSPKMixEngineOne;
+            if (fadeUpQ16 > kSPKMixEngineOne)   fadeUpQ16 = kSPKMixEngineOne;
+        }
+    }
+
+    // Calculate new A&B fade percents, as 16.16 fixed point
+    int32_t newFadeAExact = 0;
+    int32_t newFadeBExact = 0;
+
+    if (mixMode == mixBlend) 
+    {
+        // This is the correct algorithm for blend where window A occludes B.
+        // Who knew a crossfade could be so tricky. The level of B has to be factored by what A is letting through.
+        // ie. if fully faded up, top window = xfade, bottom window = 100%
+        // This will however look very wrong if A is not occluding B, ie. mismatched aspect ratios.
+        mixEngine.blend(xFadeQ16, fadeUpQ16, newFadeAExact, newFadeBExact);
+    }
+    else if (mixMode == mixAdditive)
+    {
+        // we need to set fade level of both windows according to the fade curve profile
+        mixEngine.additive(xFadeQ16, fadeUpQ16, newFadeAExact, newFadeBExact);
+    }
+    else if (mixMode == mixKeyLeft)
+    {
+        mixEngine.keyLeft(xFadeQ16, fadeUpQ16, newFadeAExact, newFadeBExact);
+    }
+    else if (mixMode == mixKeyRight)
+    {
+        mixEngine.keyRight(xFadeQ16, fadeUpQ16, newFadeAExact, newFadeBExact);
+    }
+    
+    //// TASK: Send to TVOne if percents have changed
+    
+    // Hysteresis stops a fader at rest flipping between two adjacent percents, and each flip being sent to the processor
+    int newFadeAPercent = fadeAHysteresis.process(newFadeAExact);
+    int newFadeBPercent = fadeBHysteresis.process(newFadeBExact);
+    
+    // Queue rather than send, the queue coalesces to the latest value and sends the higher first
+    if (newFadeAPercent != fadeAPercent) 
+    {
+        fadeAPercent = newFadeAPercent;
+        updateFade = true;
+        
+        fadeAPO = fadeAPercent / 100.0;
+        tvOneQueue.setFadeLevel(kTV1WindowIDA, fadeAPercent);
+    }
+    if (newFadeBPercent != fadeBPercent) 
+    {
+        fadeBPercent = newFadeBPercent;
+        updateFade = true;
+        
+        fadeBPO = fadeBPercent / 100.0;
+        tvOneQueue.setFadeLevel(kTV1WindowIDB, fadeBPercent);
+    }
+    mixXFade = xFadeQ16;
+    
+    // For comms out, which wants 0-1
+    xFade = xFadeQ16 / float(kSPKMixEngineOne);
+    fadeUp = fadeUpQ16 / float(kSPKMixEngineOne);
+    
+    if (updateFade && debug) 
+    {
+        debug->printf("xFade = %i   fadeUp = %i \r\n", xFadeAINCached, fadeUpAINCached);
+        debug->printf("xFade = %3f   fadeUp = %3f   fadeA% = %i   fadeB% = %i \r\n", xFade, fadeUp, fadeAPercent, fadeBPercent);
+        debug->printf("\r\n"); 
+    }
+    
+    return updateFade;
+}
+
+// Bulk work -- conform, uploads, resolution changes -- calls this between chunks.
+// The faders are read, and any fade or interactive edit is sent before the next chunk.
+void tvOneYieldToFades()
+{
+    processInputEvents();
+    
+    float xFade, fadeUp;
+    processMix(xFade, fadeUp);
+    
+    tvOneQueue.flushAbove(SPKTVOneQueue::priorityBulk);
+}
+
+bool actionTVOneSources(bool ok, bool RGB1, bool RGB2, int32_t sourceA, int32_t sourceB)
+{
+    static int notOKCounter = 0;
     
-    ok = ok && tvOne.readCommand(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, payload);
-    bool RGB2 = (payload == 1);
-   
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, payload);
-    int sourceA = payload;
-   
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, payload);
-    int sourceB = payload;
-   
     if (debug) debug->printf("HandleTVOneSources: RGB1: %i, RGB2: %i, sourceA: %#x, sourceB: %#x \r\n", RGB1, RGB2, sourceA, sourceB);
     
     string tvOneDetectString = "TVOne: ";
@@ -441,46 +830,31 @@ bool handleTVOneSources()
     // Note any further losses on this input will be handled by the unit holding the last frame, so we don't need to switch back to SIS.
     if (ok && !tvOneRGB1Stable)
     {
-        if (RGB1 && (sourceB != kTV1SourceRGB1)) ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB1);
-        if (!RGB1 && (sourceB != kTV1SourceSIS2)) ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceSIS2); // Wierd: Can't set to SIS1 sometimes.
+        if (RGB1 && (sourceB != kTV1SourceRGB1)) ok = ok && tvOneCache.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB1);
+        if (!RGB1 && (sourceB != kTV1SourceSIS2)) ok = ok && tvOneCache.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceSIS2); // Wierd: Can't set to SIS1 sometimes.
         if (ok && RGB1) tvOneRGB1Stable = true;
     }
     if (ok && !tvOneRGB2Stable)
     {
-        if (RGB2 && (sourceA != kTV1SourceRGB2)) ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB2);
-        if (!RGB2 && (sourceA != kTV1SourceSIS2)) ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceSIS2);
+        if (RGB2 && (sourceA != kTV1SourceRGB2)) ok = ok && tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB2);
+        if (!RGB2 && (sourceA != kTV1SourceSIS2)) ok = ok && tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceSIS2);
         if (ok && RGB2) tvOneRGB2Stable = true;
     } 
     
     // It seems there is an occasional RS232 choke around power-on of the processor.
-    // Hard to reproduce, doubly so when in debug mode, this may fix. 
+    // The link pacing backs off as commands fail and recovers as they succeed, so here we just keep the operator informed.
     if (ok)
     {
         notOKCounter = 0;
-        tvOne.resetCommandPeriods();
     }
     else 
     {
         notOKCounter++;
-        if (notOKCounter == 5)
-        {
-            tvOne.increaseCommandPeriods(200);
-        }
-        if (notOKCounter == 6)
-        {
-            tvOne.resetCommandPeriods();
-        }
         if (notOKCounter % 15 == 0)
         {
-            tvOneStatusMessage.addMessage("TVOne: Resetting link", 2.0f);
-            screen.textToBuffer(tvOneStatusMessage.message(), kTVOneStatusLine);
-            screen.sendBuffer();
-            
-            tvOne.increaseCommandPeriods(1500);
-        }
-        if (notOKCounter % 15 == 1)
-        {
-            tvOne.resetCommandPeriods();
+            tvOneStatusMessage.addMessage("TVOne: Link backing off", 2.0f);
+            tvOneCache.invalidate();
+            screenScheduler.setText(kTVOneStatusLine, tvOneStatusMessage.message());
         }
     }
     
@@ -500,9 +874,9 @@ void actionMixMode(bool reset = false)
     if (mixModeOld == mixAdditive || reset)
     {
         // Turn off Additive Mixing on output
-        if (tvOne.getProcessorType().version == 423)
+        if (tvOneProcessorVersion() == 423)
         {
-            ok = ok && tvOne.command(0, kTV1WindowIDA, 0x298, 0);
+            ok = ok && tvOneCache.command(0, kTV1WindowIDA, 0x298, 0);
         }
     }
     if (mixMode == mixAdditive) 
@@ -510,18 +884,19 @@ void actionMixMode(bool reset = false)
         sentMSGBuffer = "Additive";
     
         // First set B to what you'd expect for additive; it may be left at 100 if optimised blend mixing was previous mixmode.
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeBPercent);
+        tvOneQueue.setFadeLevel(kTV1WindowIDB, fadeBPercent);
+        ok = ok && tvOneQueue.flush();
         // Then turn on Additive Mixing
-        if (tvOne.getProcessorType().version == 423)
+        if (tvOneProcessorVersion() == 423)
         {
-            ok = ok && tvOne.command(0, kTV1WindowIDA, 0x298, 1);
+            ok = ok && tvOneCache.command(0, kTV1WindowIDA, 0x298, 1);
         }
     }
 
     if (mixModeOld == mixKeyLeft || reset)
     {
         // Turn off Keyer
-        tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, false);
+        tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, false);
     }
     
     if (mixMode == mixKeyLeft)
@@ -530,16 +905,16 @@ void actionMixMode(bool reset = false)
         mixKeyWindow = kTV1WindowIDA;
         
         // Turn on Keyer
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, true);
+        ok = ok && tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, true);
     }
 
     if (mixModeOld == mixKeyRight || reset)
     {
         // Restore window positions
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, 0);
+        ok = ok && tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, 0);
         
         // Turn off Keyer
-        tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, false); // Checkme: if check for success, returns failure errantly?
+        tvOneCache.command(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, false); // Checkme: if check for success, returns failure errantly?
     }    
     if (mixMode == mixKeyRight)
     {
@@ -547,11 +922,11 @@ void actionMixMode(bool reset = false)
         mixKeyWindow = kTV1WindowIDB;
         
         // Turn on Keyer
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, true);
+        ok = ok && tvOneCache.command(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, true);
         
         
         // Set window B above window A
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsLayerPriority, 0);
+        ok = ok && tvOneCache.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsLayerPriority, 0);
     }
     
     if (ok) 
@@ -568,135 +943,293 @@ void actionMixMode(bool reset = false)
     tvOneStatusMessage.addMessage(sentOK + sentMSGBuffer, kTVOneStatusMessageHoldTime);
 }
 
-bool checkTVOneMixStatus()
+// Housekeeping checks the processor is in the state we expect, and fixes it if not.
+// It runs as a state machine, one status read per step, so a fader move is never stuck behind a burst of status traffic.
+enum { housekeepingRGB1Stable, housekeepingRGB2Stable, housekeepingSourceA, housekeepingSourceB, housekeepingSourcesAction,
+       housekeepingAdditive, housekeepingKeyerA, housekeepingKeyerB, housekeepingLayerPriority, housekeepingMixModeAction,
+       housekeepingFadeA, housekeepingFadeB, housekeepingVerifyCache, housekeepingIdle };
+int housekeepingStep = housekeepingIdle;
+int housekeepingLastStep = housekeepingIdle;
+bool housekeepingOK = true;
+int32_t housekeepingPayloads[housekeepingIdle];
+
+void startHousekeeping(int firstStep, int lastStep)
 {
-    bool ok = true;
-    
-    int32_t payload;
-    
-    // Mix Mode
-    bool mixModeNeedsAction = false;
-    bool additiveOn = false, keyLeftOn = false, keyRightOn = false;
-    int  windowAPriority = -1;
+    housekeepingStep = firstStep;
+    housekeepingLastStep = lastStep;
+    housekeepingOK = true;
+}
+
+void stepHousekeeping()
+{
+    if (housekeepingStep == housekeepingIdle) return;
     
-    if (mixMode == mixBlend)    { additiveOn = false; keyLeftOn = false; keyRightOn = false; windowAPriority = 0;}
-    if (mixMode == mixAdditive) { additiveOn = true;  keyLeftOn = false; keyRightOn = false; windowAPriority = 0;}
-    if (mixMode == mixKeyLeft)  { additiveOn = false; keyLeftOn = true;  keyRightOn = false; windowAPriority = 0;}
-    if (mixMode == mixKeyRight) { additiveOn = false; keyLeftOn = false; keyRightOn = true;  windowAPriority = 1;}
+    bool &ok = housekeepingOK;
+    int32_t *payloads = housekeepingPayloads;
+    int32_t payload = -1;
     
-    if (tvOne.getProcessorType().version == 423)
+    switch (housekeepingStep)
     {
-        payload = -1;
-        ok = ok && tvOne.readCommand(0, kTV1WindowIDA, 0x298, payload);
-        if (payload != additiveOn) mixModeNeedsAction = true;
+        //// Sources
+        case housekeepingRGB1Stable:
+            ok = ok && tvOneCache.readLive(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, payload);
+            break;
+        case housekeepingRGB2Stable:
+            ok = ok && tvOneCache.readLive(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, payload);
+            break;
+        case housekeepingSourceA:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, payload);
+            break;
+        case housekeepingSourceB:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, payload);
+            break;
+        case housekeepingSourcesAction:
+            ok = actionTVOneSources(ok, payloads[housekeepingRGB1Stable] == 1, payloads[housekeepingRGB2Stable] == 1, payloads[housekeepingSourceA], payloads[housekeepingSourceB]);
+            break;
+            
+        //// Mix Mode
+        case housekeepingAdditive:
+            if (tvOneProcessorVersion() == 423) ok = ok && tvOneCache.readCommand(0, kTV1WindowIDA, 0x298, payload);
+            else payload = 0;
+            break;
+        case housekeepingKeyerA:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, payload);
+            break;
+        case housekeepingKeyerB:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, payload);
+            break;
+        case housekeepingLayerPriority:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, payload);
+            break;
+        case housekeepingMixModeAction:
+        {
+            bool additiveOn = false, keyLeftOn = false, keyRightOn = false;
+            int  windowAPriority = -1;
+            
+            if (mixMode == mixBlend)    { additiveOn = false; keyLeftOn = false; keyRightOn = false; windowAPriority = 0;}
+            if (mixMode == mixAdditive) { additiveOn = true;  keyLeftOn = false; keyRightOn = false; windowAPriority = 0;}
+            if (mixMode == mixKeyLeft)  { additiveOn = false; keyLeftOn = true;  keyRightOn = false; windowAPriority = 0;}
+            if (mixMode == mixKeyRight) { additiveOn = false; keyLeftOn = false; keyRightOn = true;  windowAPriority = 1;}
+            
+            // Non-423 firmware has no additive, so that read is skipped and will always match
+            if (tvOneProcessorVersion() != 423) additiveOn = false;
+            
+            bool mixModeNeedsAction = (payloads[housekeepingAdditive] != additiveOn) ||
+                                      (payloads[housekeepingKeyerA] != keyLeftOn) ||
+                                      (payloads[housekeepingKeyerB] != keyRightOn) ||
+                                      (payloads[housekeepingLayerPriority] != windowAPriority);
+            
+            if (ok && mixModeNeedsAction) 
+            {
+                if (debug) debug->printf("Check TVOne Mix Status requiring mixMode action. mixMode: %i \r\n", mixMode);
+                actionMixMode(true);
+            }
+            break;
+        }
+        
+        //// Fade
+        case housekeepingFadeA:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, payload);
+            if (ok && (payload != fadeAPercent))
+            {
+                if (debug) debug->printf("Check TVOne Mix Status requiring fadeA action");
+                tvOneQueue.setFadeLevel(kTV1WindowIDA, fadeAPercent);
+            }
+            break;
+        case housekeepingFadeB:
+            ok = ok && tvOneCache.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, payload);
+            if (ok && (payload != fadeBPercent))
+            {
+                if (debug) debug->printf("Check TVOne Mix Status requiring fadeB action");
+                tvOneQueue.setFadeLevel(kTV1WindowIDB, fadeBPercent);
+            }
+            break;
+        
+        //// Cache
+        case housekeepingVerifyCache:
+            // Lets check our cached view of the processor is still true, one register at a time
+            tvOneCache.verifyNext();
+            break;
     }
     
-    payload = -1;
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustKeyerEnable, payload);
-    if (payload != keyLeftOn) mixModeNeedsAction = true;
-
-    payload = -1;
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustKeyerEnable, payload);
-    if (payload != keyRightOn) mixModeNeedsAction = true;
+    payloads[housekeepingStep] = payload;
     
-    payload = -1;
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, payload);
-    if (payload != windowAPriority) mixModeNeedsAction = true;
+    housekeepingStep = (housekeepingStep < housekeepingLastStep) ? housekeepingStep + 1 : housekeepingIdle;
+}
 
-    if (ok && mixModeNeedsAction) 
-    {
-        if (debug) debug->printf("Check TVOne Mix Status requiring mixMode action. mixMode: %i \r\n", mixMode);
-        actionMixMode(true);
-    }
+bool runHousekeeping(int firstStep, int lastStep)
+{
+    startHousekeeping(firstStep, lastStep);
+    while (housekeepingStep != housekeepingIdle) stepHousekeeping();
+    return housekeepingOK;
+}
+
+bool handleTVOneSources()
+{
+    SPKTVOneCache::readType reads[] = {
+        {kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, -1, true},
+        {kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceSourceStable, -1, true},
+        {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, -1},
+        {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, -1},
+    };
     
-    // Check Fade
-    payload = -1;
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, payload);
-    if (ok && (payload != fadeAPercent))
-    {
-        if (debug) debug->printf("Check TVOne Mix Status requiring fadeA action");
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeAPercent);
-    }
+    bool ok = tvOneCache.readCommands(reads, 4);
     
-    payload = -1;
-    ok = ok && tvOne.readCommand(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, payload);
-    if (ok && (payload != fadeBPercent))
+    return actionTVOneSources(ok, reads[0].payload == 1, reads[1].payload == 1, reads[2].payload, reads[3].payload);
+}
+
+bool checkTVOneMixStatus()
+{
+    return runHousekeeping(housekeepingAdditive, housekeepingFadeB);
+}
+
+// The state conform puts the processor into. Only settings that differ from what the processor has are sent.
+struct conformSettingType { uint8_t source; uint8_t window; int32_t function; int32_t payload; };
+
+const conformSettingType conformSettings[] = {
+    // Independent output
+    {0, kTV1WindowIDA, kTV1FunctionMode, 2},
+    {0, kTV1WindowIDA, kTV1FunctionAdjustOutputsOutputEnable, 1},
+    {0, kTV1WindowIDA, kTV1FunctionAdjustOutputsLockMethod, 0},
+    
+    // Make sure our windows exist
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsEnable, 1},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsEnable, 1},
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, 0},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsLayerPriority, 1},
+    
+    // Turn off borders on those windows
+    {0, kTV1WindowIDA, kTV1FunctionAdjustBorderEnable, 0},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustBorderEnable, 0},
+    
+    // Assign inputs to windows, so that left on the crossfader is left on the processor viewed from front
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB2},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB1},
+    
+    // Set scaling to fit source within output, maintaining aspect ratio
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsZoomLevel, 100},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsZoomLevel, 100},
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsShrinkEnable, 0},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsShrinkEnable, 0},
+    {kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspectFit},
+    {kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspectFit},
+    {kTV1SourceSIS1, kTV1WindowIDA, kTV1FunctionAdjustSourceTestCard, 1},
+    {kTV1SourceSIS1, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspect1to1},
+    {kTV1SourceSIS2, kTV1WindowIDA, kTV1FunctionAdjustSourceTestCard, 1},
+    {kTV1SourceSIS2, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspect1to1},
+    
+    // On source loss, hold on the last frame received.
+    {kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceOnSourceLoss, 1},
+    {kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceOnSourceLoss, 1},
+};
+
+// Set after resolution, fade levels for maximum chance of being seen
+const conformSettingType conformFadeSettings[] = {
+    {0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, 50},
+    {0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, 100},
+};
+
+// Send each setting the processor doesn't already have. Stops at the first failure.
+bool conformSettingsToProcessor(const conformSettingType *conformTable, int count, int &skipped)
+{
+    bool ok = true;
+    
+    for (int first=0; ok && first < count; first += kTVOneCacheBatchSize)
     {
-        if (debug) debug->printf("Check TVOne Mix Status requiring fadeB action");
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeBPercent);
+        int batch = count - first;
+        if (batch > kTVOneCacheBatchSize) batch = kTVOneCacheBatchSize;
+        
+        tvOneYieldToFades();
+        
+        // Find out what the processor has in one exchange. A failed read leaves -1, which never matches, so is sent.
+        // Read live, as conforming is for when the processor may have been changed behind the cache's back.
+        SPKTVOneCache::readType reads[kTVOneCacheBatchSize];
+        for (int i=0; i < batch; i++)
+        {
+            const conformSettingType &setting = conformTable[first + i];
+            SPKTVOneCache::readType read = {setting.source, setting.window, setting.function, -1, true};
+            reads[i] = read;
+        }
+        tvOneCache.readCommands(reads, batch);
+        
+        for (int i=0; ok && i < batch; i++)
+        {
+            const conformSettingType &setting = conformTable[first + i];
+            
+            if (reads[i].payload == setting.payload) 
+            {
+                skipped++;
+            }
+            else
+            {
+                tvOneYieldToFades();
+                ok = tvOneCache.command(setting.source, setting.window, setting.function, setting.payload);
+            }
+        }
     }
     
     return ok;
 }
 
-bool conformProcessor()
+bool conformProcessor(int *skippedCount = NULL)
 {
     bool ok;
-                    
-    int32_t on = 1;
-    int32_t off = 0;
+    int skipped;
     
     for (int i=0; i < 3; i++)
     {
-        // Independent output
-        ok =       tvOne.command(0, kTV1WindowIDA, kTV1FunctionMode, 2);
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustOutputsOutputEnable, on);
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustOutputsLockMethod, off);
-                        
-        // Make sure our windows exist
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsEnable, on);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsEnable, on);
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsLayerPriority, 0);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsLayerPriority, 1);
-        
-        // Turn off borders on those windows                
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustBorderEnable, off);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustBorderEnable, off);
-            
-        // Assign inputs to windows, so that left on the crossfader is left on the processor viewed from front
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB2);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsWindowSource, kTV1SourceRGB1);
-        
-        // Set scaling to fit source within output, maintaining aspect ratio
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsZoomLevel, 100);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsZoomLevel, 100);
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsShrinkEnable, off);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsShrinkEnable, off);
-        ok = ok && tvOne.command(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspectFit);
-        ok = ok && tvOne.command(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspectFit);
-        ok = ok && tvOne.command(kTV1SourceSIS1, kTV1WindowIDA, kTV1FunctionAdjustSourceTestCard, 1);
-        ok = ok && tvOne.command(kTV1SourceSIS1, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspect1to1);
-        ok = ok && tvOne.command(kTV1SourceSIS2, kTV1WindowIDA, kTV1FunctionAdjustSourceTestCard, 1);
-        ok = ok && tvOne.command(kTV1SourceSIS2, kTV1WindowIDA, kTV1FunctionAdjustSourceAspectCorrect, SPKTVOne::aspect1to1);
-        
-        // On source loss, hold on the last frame received.
-        int32_t freeze = 1;
-        ok = ok && tvOne.command(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceOnSourceLoss, freeze);
-        ok = ok && tvOne.command(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceOnSourceLoss, freeze);
-        
-        // Set resolution and fade levels for maximum chance of being seen
-        ok = ok && tvOne.setResolution(kTV1ResolutionVGA, 5);
-        ok = ok && tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, 50);
-        ok = ok && tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, 100);
+        skipped = 0;
+        
+        ok = conformSettingsToProcessor(conformSettings, sizeof(conformSettings)/sizeof(conformSettingType), skipped);
+        
+        // Set resolution. We can't read this back, so it is always sent.
+        tvOneYieldToFades();
+        ok = ok && tvOneLibrary().setResolution(kTV1ResolutionVGA, 5);
+        tvOneCache.invalidate(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID);
+        tvOneCache.invalidate(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID);
+        
+        ok = ok && conformSettingsToProcessor(conformFadeSettings, sizeof(conformFadeSettings)/sizeof(conformSettingType), skipped);
         
         // Set evil, evil HDCP off
-        ok = ok && tvOne.setHDCPOn(false);
+        if (ok)
+        {
+            SPKTVOneCache::readType hdcpReads[] = {
+                {0, kTV1WindowIDA, kTV1FunctionAdjustOutputsHDCPRequired, -1, true},
+                {kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, -1, true},
+                {kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, -1, true},
+            };
+            bool hdcpKnown = tvOneCache.readCommands(hdcpReads, 3);
+            
+            if (hdcpKnown && hdcpReads[0].payload == 0 && hdcpReads[1].payload == 0 && hdcpReads[2].payload == 0)
+            {
+                skipped++;
+            }
+            else
+            {
+                tvOneYieldToFades();
+                ok = tvOneLibrary().setHDCPOn(false);
+                tvOneCache.invalidate(0, kTV1WindowIDA, kTV1FunctionAdjustOutputsHDCPRequired);
+                tvOneCache.invalidate(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize);
+                tvOneCache.invalidate(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize);
+            }
+        }
     
+        // Failed commands will have backed off the link pacing for the next attempt
         if (ok) break;
-        else tvOne.increaseCommandPeriods(500);
     }
     
     if (ok)
     {
         // Save current state in preset one
-        tvOne.command(0, kTV1WindowIDA, kTV1FunctionPreset, 1);          // Set Preset 1
-        tvOne.command(0, kTV1WindowIDA, kTV1FunctionPresetStore, 1);     // Store
+        tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPreset, 1);          // Set Preset 1
+        tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPresetStore, 1);     // Store
         
         // Save current state for power on
-        tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+        tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
     }
     
-    tvOne.resetCommandPeriods();
+    if (debug) debug->printf("Conform %s, %i settings already set \r\n", ok ? "OK" : "failed", skipped);
+    if (skippedCount) *skippedCount = skipped;
     
     return ok;
 }
@@ -709,7 +1242,7 @@ bool uploadToProcessor()
     FILE *file;
     
     // Upload EDIDs
-    if (tvOne.getProcessorType().version < 415)
+    if (tvOneProcessorVersion() < 415)
     {
         if (debug) debug->printf("Skipping EDID upload as unsupported on detected TV One firmware\r\n");
     }
@@ -719,7 +1252,8 @@ bool uploadToProcessor()
         file = fopen("/local/matroxe.did", "r"); // 8.3, avoid .bin as mbed executable extension
         if (file)
         {
-            ok = ok && tvOne.uploadEDID(file, 3);   
+            tvOneYieldToFades();
+            ok = ok && tvOneLibrary().uploadEDID(file, 3);   
             fclose(file);
         }
         else
@@ -731,7 +1265,8 @@ bool uploadToProcessor()
         file = fopen("/local/x4e.did", "r"); // 8.3, avoid .bin as mbed executable extension
         if (file)
         {
-            ok = ok && tvOne.uploadEDID(file, 2);   
+            tvOneYieldToFades();
+            ok = ok && tvOneLibrary().uploadEDID(file, 2);   
             fclose(file);
         }
         else
@@ -745,7 +1280,8 @@ bool uploadToProcessor()
         file = fopen("/local/spark.dat", "r"); // 8.3, avoid .bin as mbed executable extension
         if (file)
         {
-            ok = ok && tvOne.uploadImage(file, 0);   
+            tvOneYieldToFades();
+            ok = ok && tvOneLibrary().uploadImage(file, 0);   
             fclose(file);
         }
         else
@@ -771,7 +1307,7 @@ void setMixModeMenuItems()
 {
     mixModeMenu.clearMenuItems();
     
-    if (tvOne.getProcessorType().version == 423 || tvOne.getProcessorType().version == -1)
+    if (tvOneProcessorVersion() == 423 || tvOneProcessorVersion() == -1)
     {
         mixModeAdditiveMenu.title = "Crossfade";
         mixModeMenu.addMenuItem(SPKMenuItem(mixModeAdditiveMenu.title, &mixModeAdditiveMenu));
@@ -781,6 +1317,12 @@ void setMixModeMenuItems()
         mixModeMenu.addMenuItem(SPKMenuItem("Blend", mixBlend));
     }
     
+    mixModeTransitionMenu.title = "Auto Transition";
+    mixModeMenu.addMenuItem(SPKMenuItem(mixModeTransitionMenu.title, &mixModeTransitionMenu));
+    
+    mixModePredictionMenu.title = "Fader Prediction";
+    mixModeMenu.addMenuItem(SPKMenuItem(mixModePredictionMenu.title, &mixModePredictionMenu));
+    
     mixModeMenu.addMenuItem(SPKMenuItem("Key: Left over Right", mixKeyLeft));
     mixModeMenu.addMenuItem(SPKMenuItem("Key: Right over Left", mixKeyRight));
     mixModeMenu.addMenuItem(SPKMenuItem("Key: Tweak key values", &mixModeUpdateKeyMenu));
@@ -792,6 +1334,15 @@ void setMixModeMenuItems()
             mixModeMenu.addMenuItem(SPKMenuItem("Key Preset: " + settings.keyerParamName(i), mixKeyPresetStartIndex + i));
         }
     
+    // Curves from settings, for whichever fader each is for
+    for (int i=0; i < settings.faderCurveCount(); i++)
+    {
+        if (settings.faderCurve(i).appliesTo(SPKFaderCurve::faderXFade))
+            mixModeMenu.addMenuItem(SPKMenuItem("XFade Curve: " + settings.faderCurveName(i), mixCurveStartIndex + i*2));
+        if (settings.faderCurve(i).appliesTo(SPKFaderCurve::faderFadeUp))
+            mixModeMenu.addMenuItem(SPKMenuItem("FadeUp Curve: " + settings.faderCurveName(i), mixCurveStartIndex + i*2 + 1));
+    }
+    
     mixModeMenu.addMenuItem(SPKMenuItem("Back to Main Menu", &mainMenu));
 }
 
@@ -832,14 +1383,17 @@ void setCommsMenuItems()
 
 void mixModeAdditiveMenuHandler(int change, bool action)
 {
+    menuEnc.setAcceleration(kEncoderAccelerationFadeCurve);
+    
     fadeCurve += change * 0.05f;
     if (fadeCurve > 1.0f) fadeCurve = 1.0f;
     if (fadeCurve < 0.0f) fadeCurve = 0.0f;
+    mixEngine.setFadeCurve(fadeCurve);
     
     mixMode = (fadeCurve > 0.001f) ? mixAdditive: mixBlend;
 
     screen.clearBufferRow(kMenuLine2);
-    screen.textToBuffer("Blend [ ----- ] Add", kMenuLine2);
+    screen.labelToBuffer("Blend [ ----- ] Add", kMenuLine2);
     screen.characterToBuffer('X', 38 + fadeCurve*20.0f, kMenuLine2);
     
     if (debug) debug->printf("Fade curve changed by %i to %f \r\n", change, fadeCurve);
@@ -850,8 +1404,55 @@ void mixModeAdditiveMenuHandler(int change, bool action)
         
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
+    }
+}
+
+void mixModeTransitionMenuHandler(int change, bool action)
+{
+    menuEnc.setAcceleration(kEncoderAccelerationDuration);
+    
+    settings.transition.durationMillis += change * 100;
+    if (settings.transition.durationMillis < 100) settings.transition.durationMillis = 100;
+    if (settings.transition.durationMillis > 30000) settings.transition.durationMillis = 30000;
+    
+    char paramLine[kStringBufferLength];
+    snprintf(paramLine, kStringBufferLength, "%.1fs. Press to take", settings.transition.durationMillis / 1000.0f);
+    screen.clearBufferRow(kMenuLine2);
+    screen.textToBuffer(paramLine, kMenuLine2);
+    
+    if (action)
+    {
+        autoTransitionRequested = true;
+        
+        selectedMenu = &mixModeMenu;
+        
+        screen.clearBufferRow(kMenuLine1);
+        screen.clearBufferRow(kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
+    }
+}
+
+void mixModePredictionMenuHandler(int change, bool action)
+{
+    // Any turn flips it, as there are only the two
+    if (change % 2) settings.prediction.enabled = !settings.prediction.enabled;
+    
+    screen.clearBufferRow(kMenuLine2);
+    screen.labelToBuffer(settings.prediction.enabled ? "On. Turn to change" : "Off. Turn to change", kMenuLine2);
+    
+    if (action)
+    {
+        selectedMenu = &mixModeMenu;
+        
+        tvOneStatusMessage.addMessage(settings.prediction.enabled ? "Fader prediction on" : "Fader prediction off", kTVOneStatusMessageHoldTime);
+        
+        screen.clearBufferRow(kMenuLine1);
+        screen.clearBufferRow(kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -864,14 +1465,16 @@ void troubleshootingMenuHDCPHandler(int change, bool action)
     {
         // We check the control not the status, as status depends on connection etc.
         
-        int32_t payloadOutput = -1;
-        tvOne.readCommand(0, kTV1WindowIDA, kTV1FunctionAdjustOutputsHDCPRequired, payloadOutput);
-        
-        int32_t payload1 = -1;
-        tvOne.readCommand(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, payload1);
+        SPKTVOneCache::readType reads[] = {
+            {0, kTV1WindowIDA, kTV1FunctionAdjustOutputsHDCPRequired, -1},
+            {kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, -1},
+            {kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, -1},
+        };
+        tvOneCache.readCommands(reads, 3);
         
-        int32_t payload2 = -1;
-        tvOne.readCommand(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceHDCPAdvertize, payload2);
+        int32_t payloadOutput = reads[0].payload;
+        int32_t payload1 = reads[1].payload;
+        int32_t payload2 = reads[2].payload;
    
         if ((payloadOutput == payload1) && (payload1 == payload2) && (payload2 == 0)) 
         {
@@ -906,14 +1509,14 @@ void troubleshootingMenuHDCPHandler(int change, bool action)
     {
         if (state == 0)
         {
-            screen.clearBufferRow(kTVOneStatusLine);
-            screen.textToBuffer("Setting HDCP...", kTVOneStatusLine);
-            screen.sendBuffer();
+            screenScheduler.setText(kTVOneStatusLine, "Setting HDCP...");
+            screenScheduler.flush();
         
             // Do the action
-            bool ok = tvOne.setHDCPOn(currentHDCP == 0);
+            bool ok = tvOneLibrary().setHDCPOn(currentHDCP == 0);
+            tvOneCache.invalidate();
             
-            if (ok) tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+            if (ok) tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
             
             std::string sendOK = ok ? "Sent: HDCP " : "Send Error: HDCP ";
             sendOK += currentHDCP == 0 ? "On" : "Off";
@@ -926,8 +1529,8 @@ void troubleshootingMenuHDCPHandler(int change, bool action)
         
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -939,7 +1542,7 @@ void troubleshootingMenuEDIDHandler(int change, bool action)
     
     if (change == 0 && !action)
     {
-        currentEDID = tvOne.getEDID();
+        currentEDID = tvOneLibrary().getEDID();
         
         if (currentEDID == -1) currentEDIDPassthrough = -1;
         else currentEDIDPassthrough = (currentEDID == EDIDPassthroughSlot) ? 1 : 0;
@@ -962,9 +1565,8 @@ void troubleshootingMenuEDIDHandler(int change, bool action)
     {
         if (state == 0)
         {
-            screen.clearBufferRow(kTVOneStatusLine);
-            screen.textToBuffer("Setting EDID...", kTVOneStatusLine);
-            screen.sendBuffer();
+            screenScheduler.setText(kTVOneStatusLine, "Setting EDID...");
+            screenScheduler.flush();
         
             // Do the action
             tvOneEDIDPassthrough = currentEDIDPassthrough == 0;
@@ -976,14 +1578,14 @@ void troubleshootingMenuEDIDHandler(int change, bool action)
             
             if (newEDID != currentEDID)
             {
-                ok = ok && tvOne.command(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID, newEDID);
-                ok = ok && tvOne.command(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID, newEDID);
+                ok = ok && tvOneCache.command(kTV1SourceRGB1, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID, newEDID);
+                ok = ok && tvOneCache.command(kTV1SourceRGB2, kTV1WindowIDA, kTV1FunctionAdjustSourceEDID, newEDID);
                 if (ok) message = "Sent: EDID";
                 else    message = "Send Error: EDID";
             }
             else        message = "EDID already set";
         
-            if (ok) tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+            if (ok) tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
             
             tvOneStatusMessage.addMessage(message, kTVOneStatusMessageHoldTime);
             
@@ -996,8 +1598,8 @@ void troubleshootingMenuEDIDHandler(int change, bool action)
         
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -1007,7 +1609,7 @@ void troubleshootingMenuAspectHandler(int change, bool action)
 
     if (change == 0 && !action)
     {
-        switch (tvOne.getAspect())
+        switch (tvOneLibrary().getAspect())
         {
             case SPKTVOne::aspectFit : state = 0; break;
             case SPKTVOne::aspectHFill : state = 1; break;
@@ -1024,29 +1626,29 @@ void troubleshootingMenuAspectHandler(int change, bool action)
     screen.clearBufferRow(kMenuLine2);
     switch (state) 
     {
-        case 0: screen.textToBuffer("Set: [Fit/    /   /      ]", kMenuLine2); break;
-        case 1: screen.textToBuffer("Set: [   /Fill/   /      ]", kMenuLine2); break;
-        case 2: screen.textToBuffer("Set: [   /    /1:1/      ]", kMenuLine2); break;
-        case 3: screen.textToBuffer("Set: [   /    /   /Cancel]", kMenuLine2); break;
+        case 0: screen.labelToBuffer("Set: [Fit/    /   /      ]", kMenuLine2); break;
+        case 1: screen.labelToBuffer("Set: [   /Fill/   /      ]", kMenuLine2); break;
+        case 2: screen.labelToBuffer("Set: [   /    /1:1/      ]", kMenuLine2); break;
+        case 3: screen.labelToBuffer("Set: [   /    /   /Cancel]", kMenuLine2); break;
     }
       
     if (action)
     {
         if (state != 3)
         {
-            screen.clearBufferRow(kTVOneStatusLine);
-            screen.textToBuffer("Setting Aspect...", kTVOneStatusLine);
-            screen.sendBuffer();
+            screenScheduler.setText(kTVOneStatusLine, "Setting Aspect...");
+            screenScheduler.flush();
         
             // Do the action
             bool ok = false;
             switch (state) 
             {
-                case 0: ok = tvOne.setAspect(SPKTVOne::aspectFit); break;
-                case 1: ok = tvOne.setAspect(SPKTVOne::aspectSPKFill); break;
-                case 2: ok = tvOne.setAspect(SPKTVOne::aspect1to1); break;
+                case 0: ok = tvOneLibrary().setAspect(SPKTVOne::aspectFit); break;
+                case 1: ok = tvOneLibrary().setAspect(SPKTVOne::aspectSPKFill); break;
+                case 2: ok = tvOneLibrary().setAspect(SPKTVOne::aspect1to1); break;
             }
-            if (ok) tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+            tvOneCache.invalidate();
+            if (ok) tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
             
             std::string sendOK = ok ? "Sent: " : "Send Error: ";
             switch (state) 
@@ -1063,8 +1665,8 @@ void troubleshootingMenuAspectHandler(int change, bool action)
         
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -1084,26 +1686,26 @@ void troubleshootingMenuMatroxHandler(int change, bool action)
     screen.clearBufferRow(kMenuLine2);
     switch (state) 
     {
-        case 0: screen.textToBuffer("Set: [Digital/      /      ]", kMenuLine2); break;
-        case 1: screen.textToBuffer("Set: [       /Analog/      ]", kMenuLine2); break;
-        case 2: screen.textToBuffer("Set: [       /      /Cancel]", kMenuLine2); break;
+        case 0: screen.labelToBuffer("Set: [Digital/      /      ]", kMenuLine2); break;
+        case 1: screen.labelToBuffer("Set: [       /Analog/      ]", kMenuLine2); break;
+        case 2: screen.labelToBuffer("Set: [       /      /Cancel]", kMenuLine2); break;
     }
       
     if (action)
     {
         if (state != 2)
         {
-            screen.clearBufferRow(kTVOneStatusLine);
-            screen.textToBuffer("Configuring...", kTVOneStatusLine);
-            screen.sendBuffer();
+            screenScheduler.setText(kTVOneStatusLine, "Configuring...");
+            screenScheduler.flush();
         
             // Do the action
             bool ok = false;
             switch (state) 
             {
-                case 0: ok = tvOne.setMatroxResolutions(true); break;
-                case 1: ok = tvOne.setMatroxResolutions(false); break;
+                case 0: ok = tvOneLibrary().setMatroxResolutions(true); break;
+                case 1: ok = tvOneLibrary().setMatroxResolutions(false); break;
             }
+            tvOneCache.invalidate();
             
             std::string sendOK = ok ? "Sent: " : "Send Error: ";
             switch (state) 
@@ -1119,8 +1721,8 @@ void troubleshootingMenuMatroxHandler(int change, bool action)
         
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -1132,30 +1734,36 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
     if (mixMode == mixKeyLeft)  mixKeyWindow = kTV1WindowIDA;
     if (mixMode == mixKeyRight) mixKeyWindow = kTV1WindowIDB;
     
-    if (action) actionCount++;
+    if (action)
+    {
+        // Whatever was being tweaked should be on the processor before moving on
+        tvOneQueue.flushParameters();
+        actionCount++;
+    }
     
     if (actionCount == 0) 
     {
         settings.editingKeyerSetIndex = 0;
         
-        bool ok;
-        int minY, maxY, minU, maxU, minV, maxV;
-    
-        ok =       tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, minY); 
-        ok = ok && tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, maxY); 
-        ok = ok && tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, minU); 
-        ok = ok && tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, maxU); 
-        ok = ok && tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, minV); 
-        ok = ok && tvOne.readCommand(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, maxV);
+        SPKTVOneCache::readType reads[] = {
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, 0},
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, 0},
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, 0},
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, 0},
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, 0},
+            {0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, 0},
+        };
+        
+        bool ok = tvOneCache.readCommands(reads, 6);
         
         if (ok)
         {
-            settings.setEditingKeyerSetValue(SPKSettings::minY, minY);
-            settings.setEditingKeyerSetValue(SPKSettings::maxY, maxY);
-            settings.setEditingKeyerSetValue(SPKSettings::minU, minU);
-            settings.setEditingKeyerSetValue(SPKSettings::maxU, maxU);
-            settings.setEditingKeyerSetValue(SPKSettings::minV, minV);
-            settings.setEditingKeyerSetValue(SPKSettings::maxV, maxV);
+            settings.setEditingKeyerSetValue(SPKSettings::minY, reads[0].payload);
+            settings.setEditingKeyerSetValue(SPKSettings::maxY, reads[1].payload);
+            settings.setEditingKeyerSetValue(SPKSettings::minU, reads[2].payload);
+            settings.setEditingKeyerSetValue(SPKSettings::maxU, reads[3].payload);
+            settings.setEditingKeyerSetValue(SPKSettings::minV, reads[4].payload);
+            settings.setEditingKeyerSetValue(SPKSettings::maxV, reads[5].payload);
         }
         else
         {
@@ -1171,7 +1779,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Tweak or start over?", kMenuLine1);
+        screen.labelToBuffer("Tweak or start over?", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         
@@ -1199,16 +1807,19 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
             settings.setEditingKeyerSetValue(SPKSettings::maxU,255);
             settings.setEditingKeyerSetValue(SPKSettings::minV,0);
             settings.setEditingKeyerSetValue(SPKSettings::maxV,255);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, 0);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, 255);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, 0);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, 255);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, 0);
-            tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, 255);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, 0);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, 255);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, 0);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, 255);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, 0);
+            tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, 255);
         }
         
         actionCount = 3;
     }
+    // Choosing tweak or start over is a step at a time, the 0-255 values are swept
+    menuEnc.setAcceleration(actionCount >= 3 ? kEncoderAccelerationKeyer : kSPKEncoderAccelerationOff);
+    
     if (actionCount == 3)
     {
         int value = settings.editingKeyerSetValue(SPKSettings::maxY);
@@ -1219,13 +1830,13 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Down until unmasked", kMenuLine1);
+        screen.labelToBuffer("Down until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[   /%3i][   /   ][   /   ]", value);
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, value);   
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, value);   
     }
     else if (actionCount == 4)
     {
@@ -1237,14 +1848,14 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Up until unmasked", kMenuLine1);
+        screen.labelToBuffer("Up until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[%3i/%3i][   /   ][   /   ]", value,
                                                                                 settings.editingKeyerSetValue(SPKSettings::maxY));
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, value); 
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, value); 
     }
     else if (actionCount == 5)
     {
@@ -1256,7 +1867,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Down until unmasked", kMenuLine1);
+        screen.labelToBuffer("Down until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[%3i/%3i][   /%3i][   /   ]", settings.editingKeyerSetValue(SPKSettings::minY), 
@@ -1264,7 +1875,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
                                                                                 value);
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, value); 
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, value); 
     }
     else if (actionCount == 6)
     {
@@ -1276,7 +1887,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Up until unmasked", kMenuLine1);
+        screen.labelToBuffer("Up until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[%3i/%3i][%3i/%3i][   /   ]", settings.editingKeyerSetValue(SPKSettings::minY), 
@@ -1285,7 +1896,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
                                                                                 settings.editingKeyerSetValue(SPKSettings::maxU));
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, value);
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, value);
     }
     else if (actionCount == 7)
     {
@@ -1297,7 +1908,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Down until unmasked", kMenuLine1);
+        screen.labelToBuffer("Down until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[%3i/%3i][%3i/%3i][   /%3i]", settings.editingKeyerSetValue(SPKSettings::minY), 
@@ -1307,7 +1918,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
                                                                                 value);
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, value);    
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, value);    
     }
     else if (actionCount == 8)
     {
@@ -1319,7 +1930,7 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
 
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Up until unmasked", kMenuLine1);
+        screen.labelToBuffer("Up until unmasked", kMenuLine1);
         
         char paramLine[kStringBufferLength];
         snprintf(paramLine, kStringBufferLength, "[%3i/%3i][%3i/%3i][%3i/%3i]", settings.editingKeyerSetValue(SPKSettings::minY), 
@@ -1330,12 +1941,12 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
                                                                                 settings.editingKeyerSetValue(SPKSettings::maxV));
         screen.textToBuffer(paramLine, kMenuLine2);
         
-        tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, value);    
+        tvOneQueue.setParameter(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, value);    
     }
     else if (actionCount == 9)
     {
         // Save settings
-        tvOne.command(0, mixKeyWindow, kTV1FunctionPowerOnPresetStore, 1);
+        tvOneCache.command(0, mixKeyWindow, kTV1FunctionPowerOnPresetStore, 1);
     
         // Get back to menu
         actionCount = 0;
@@ -1343,8 +1954,8 @@ void mixModeUpdateKeyMenuHandler(int menuChange, bool action)
         selectedMenu = &mixModeMenu;
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
@@ -1357,17 +1968,17 @@ void troubleshootingMenuResetHandler(int menuChange, bool action)
     if (actionCount == 0)
     {
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Follow instructions... [+]", kMenuLine2);  
+        screen.labelToBuffer("Follow instructions... [+]", kMenuLine2);  
     }
     if (actionCount == 1)
     {
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("On Processor find...   [+]", kMenuLine2);  
+        screen.labelToBuffer("On Processor find...   [+]", kMenuLine2);  
     }
     if (actionCount == 2)
     {
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("MENU+STANDBY buttons[+]", kMenuLine2);
+        screen.labelToBuffer("MENU+STANDBY buttons[+]", kMenuLine2);
     }
     if (actionCount == 3)
     {
@@ -1384,19 +1995,24 @@ void troubleshootingMenuResetHandler(int menuChange, bool action)
         }
         
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Hold buttons for [+]", kMenuLine2);
+        screen.labelToBuffer("Hold buttons for [+]", kMenuLine2);
     }
     if (actionCount == 4)
     {
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Updating processor [-]", kMenuLine2);
-        screen.clearBufferRow(kTVOneStatusLine);
-        screen.textToBuffer("Sending...", kTVOneStatusLine);
-        screen.sendBuffer();
+        screen.labelToBuffer("Updating processor [-]", kMenuLine2);
+        screenScheduler.setText(kTVOneStatusLine, "Sending...");
+        screenScheduler.flush();
+        
+        // The processor has just been factory reset, nothing we know about it holds
+        tvOneCache.invalidate();
     
-        bool ok = conformProcessor();
+        int skipped = 0;
+        bool ok = conformProcessor(&skipped);
         
-        std::string sendOK = ok ? "TVOne: Reset success" : "Send Error: Reset";
+        char sendOK[kStringBufferLength];
+        if (ok) snprintf(sendOK, kStringBufferLength, "TVOne: Reset OK, %i same", skipped);
+        else    snprintf(sendOK, kStringBufferLength, "Send Error: Reset");
     
         tvOneStatusMessage.addMessage(sendOK, kTVOneStatusMessageHoldTime);
         
@@ -1409,7 +2025,7 @@ void troubleshootingMenuResetHandler(int menuChange, bool action)
     if (actionCount == 5)
     {
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer("Reset complete [DONE]", kMenuLine2);
+        screen.labelToBuffer("Reset complete [DONE]", kMenuLine2);
     }
     if (actionCount == 6)
     {
@@ -1418,11 +2034,149 @@ void troubleshootingMenuResetHandler(int menuChange, bool action)
         selectedMenu = &troubleshootingMenu;
         screen.clearBufferRow(kMenuLine1);
         screen.clearBufferRow(kMenuLine2);
-        screen.textToBuffer(selectedMenu->title, kMenuLine1);
-        screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+        screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+        screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     }
 }
 
+#ifdef kTVOneBenchmark
+// Moves fade A end to end and back through the real queue, cache and housekeeping, against the simulated processor.
+// Reports commands per second, and percentiles of the time from fader move to register change.
+// Fade A is left at fadeAPercent, as it was.
+void benchmarkTVOneLink(int seconds)
+{
+    const int sampleMax = 256;
+    int latencies[sampleMax];
+    int sampleCount = 0;
+    uint32_t movedMillis[101];
+    for (int i=0; i <= 100; i++) movedMillis[i] = 0;
+    
+    int commandsBefore = tvOneSim->commandCount();
+    uint32_t startMillis = tvOneSim->millis();
+    uint32_t lastMoveMillis = startMillis;
+    uint32_t lastChangedMillis = tvOneSim->registerChangedMillis(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel);
+    int percent = 0;
+    int step = 1;
+    
+    while (tvOneSim->millis() - startMillis < uint32_t(seconds) * 1000)
+    {
+        uint32_t now = tvOneSim->millis();
+        
+        // A percent every 5ms, so end to end in half a second
+        if (now - lastMoveMillis >= 5)
+        {
+            lastMoveMillis = now;
+            percent += step;
+            if (percent == 0 || percent == 100) step = -step;
+            if (movedMillis[percent] == 0) movedMillis[percent] = now;
+            tvOneQueue.setFadeLevel(kTV1WindowIDA, percent);
+        }
+        
+        // As the main loop
+        tvOneCache.poll();
+        tvOneQueue.service();
+        if (tvOneQueue.isClearFor(SPKTVOneQueue::priorityHousekeeping))
+        {
+            if (housekeepingStep == housekeepingIdle) startHousekeeping(housekeepingRGB1Stable, housekeepingVerifyCache);
+            stepHousekeeping();
+        }
+        
+        uint32_t changedMillis = tvOneSim->registerChangedMillis(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel);
+        if (changedMillis != lastChangedMillis)
+        {
+            lastChangedMillis = changedMillis;
+            
+            int landed = tvOneSim->registerValue(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel);
+            uint32_t landedMovedMillis = movedMillis[landed];
+            if (landedMovedMillis && sampleCount < sampleMax) latencies[sampleCount++] = changedMillis - landedMovedMillis;
+            
+            // Moves up to this one have been coalesced away
+            for (int i=0; i <= 100; i++) if (movedMillis[i] <= landedMovedMillis) movedMillis[i] = 0;
+        }
+    }
+    
+    tvOneQueue.setFadeLevel(kTV1WindowIDA, fadeAPercent);
+    tvOneQueue.flush();
+    
+    int elapsedMillis = tvOneSim->millis() - startMillis;
+    int commandsPerSecond = (tvOneSim->commandCount() - commandsBefore) * 1000 / elapsedMillis;
+    
+    // Insertion sort, it's only a few hundred
+    for (int i=1; i < sampleCount; i++)
+    {
+        int latency = latencies[i];
+        int j = i - 1;
+        for (; j >= 0 && latencies[j] > latency; j--) latencies[j+1] = latencies[j];
+        latencies[j+1] = latency;
+    }
+    
+    int p50 = sampleCount ? latencies[sampleCount*50/100] : -1;
+    int p90 = sampleCount ? latencies[sampleCount*90/100] : -1;
+    int p99 = sampleCount ? latencies[sampleCount*99/100] : -1;
+    int max = sampleCount ? latencies[sampleCount-1] : -1;
+    
+    if (debug) 
+    {
+        debug->printf("TVOne sim: %i commands/s, %i dropped, %i frame errors \r\n", commandsPerSecond, tvOneSim->dropCount(), tvOneSim->errorCount());
+        debug->printf("TVOne sim: fader to register ms p50 %i p90 %i p99 %i max %i, from %i samples \r\n", p50, p90, p99, max, sampleCount);
+    }
+    
+    char message[kStringBufferLength];
+    snprintf(message, kStringBufferLength, "Sim: %i cmd/s, p90 %ims", commandsPerSecond, p90);
+    tvOneStatusMessage.addMessage(message, kTVOneStatusMessageHoldTime);
+}
+#endif
+
+#ifdef kSPKMixEngineBenchmark
+// Blend over a grid of positions, as the float and double formula main.cpp had, then as SPKMixEngine::blend.
+// Reports core cycles per call for each, loop and array loads included in both.
+void benchmarkMixEngine()
+{
+    const int side = 33;
+    float positions[side];
+    int32_t positionsQ16[side];
+    for (int i=0; i < side; i++)
+    {
+        positionsQ16[i] = (i * kSPKMixEngineOne) / (side - 1);
+        positions[i] = positionsQ16[i] / float(kSPKMixEngineOne);
+    }
+    
+    const int calls = (side - 1) * side;
+    volatile int sink = 0;
+    Timer timer;
+    
+    // From 1, as a crossfade of 0 doesn't divide
+    timer.start();
+    for (int i=1; i < side; i++)
+    {
+        for (int j=0; j < side; j++)
+        {
+            float xFade = positions[i];
+            float fadeUp = positions[j];
+            sink = int((1.0-xFade) * fadeUp * 100.0);
+            sink = int((xFade*fadeUp) / (1.0 - fadeUp + xFade*fadeUp) * 100.0);
+        }
+    }
+    int floatMicros = timer.read_us();
+    
+    timer.reset();
+    for (int i=1; i < side; i++)
+    {
+        for (int j=0; j < side; j++)
+        {
+            int32_t fadeA, fadeB;
+            mixEngine.blend(positionsQ16[i], positionsQ16[j], fadeA, fadeB);
+            sink = fadeA >> 16;
+            sink = fadeB >> 16;
+        }
+    }
+    int engineMicros = timer.read_us();
+    
+    int cyclesPerMicro = SystemCoreClock / 1000000;
+    if (debug) debug->printf("Mix engine: blend %i cycles, float formula %i cycles, per call \r\n", engineMicros * cyclesPerMicro / calls, floatMicros * cyclesPerMicro / calls);
+}
+#endif
+
 int main() 
 {
     if (debug) 
@@ -1433,9 +2187,10 @@ int main()
     }
     
     // Set display font
-    screen.fontStartCharacter = &characterBytesStartChar;
-    screen.fontEndCharacter = &characterBytesEndChar;
-    screen.fontCharacters = characterBytes;
+    screen.fontStartCharacter = &fontStartChar;
+    screen.fontEndCharacter = &fontEndChar;
+    screen.fontOffsets = fontOffsets;
+    screen.fontColumns = fontColumns;
     
     // Splash screen
     string softwareLine = "SW ";
@@ -1454,10 +2209,15 @@ int main()
         screen.textToBuffer(softwareLine, 1); 
     }
     
+    screenScheduler.setFrameRate(settings.display.frameRateHz);
+    screenScheduler.setInterval(kCommsStatusLine, kCommsStatusIntervalMillis);
+    
     // Set menu structure
     mixModeMenu.title = "Mix Mode";
     mixModeAdditiveMenu.addMenuItem(SPKMenuItem(&mixModeAdditiveMenuHandler));
     mixModeUpdateKeyMenu.addMenuItem(SPKMenuItem(&mixModeUpdateKeyMenuHandler));
+    mixModeTransitionMenu.addMenuItem(SPKMenuItem(&mixModeTransitionMenuHandler));
+    mixModePredictionMenu.addMenuItem(SPKMenuItem(&mixModePredictionMenuHandler));
 
     setMixModeMenuItems();
 
@@ -1498,10 +2258,29 @@ int main()
       
     selectedMenu = &mainMenu;
       
+    // TVOne link, pace commands by measured round-trip time
+    tvOneCache.setPacing(&tvOnePacing);
+    tvOneAsync.setPacing(&tvOnePacing);
+    tvOneCache.setAsync(&tvOneAsync);
+    
+    // Simulated processor, see top
+#ifdef kTVOneBenchmark
+    tvOneAsync.setSimulator(tvOneSim);
+    benchmarkTVOneLink(10);
+#endif
+    
+#ifdef kSPKMixEngineBenchmark
+    benchmarkMixEngine();
+#endif
+      
     // Misc I/O stuff
     
     fadeAPO.period(0.001);
     fadeBPO.period(0.001);
+    
+    // From now on the ADC is the sampler's
+    faderSampler.start(kSPKFaderSamplerRateHz);
+    menuEnc.setQueue(&inputQueue);
 
     // If we do not have two solid sources, act on this as we rely on the window having a source for crossfade behaviour
     // Once we've had two solid inputs, don't check any more as we're ok as the unit is set to hold on last frame.
@@ -1513,19 +2292,19 @@ int main()
     // Display menu and framing lines
     screen.horizLineToBuffer(kMenuLine1*pixInPage - 1);
     screen.clearBufferRow(kMenuLine1);
-    screen.textToBuffer(selectedMenu->title, kMenuLine1);
+    screen.labelToBuffer(selectedMenu->title, kMenuLine1);
     screen.clearBufferRow(kMenuLine2);
-    screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+    screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
     screen.horizLineToBuffer(kMenuLine2*pixInPage + pixInPage);
     screen.horizLineToBuffer(kCommsStatusLine*pixInPage - 1);
-    screen.clearBufferRow(kTVOneStatusLine);
-    screen.textToBuffer(tvOneStatusMessage.message(), kTVOneStatusLine);
-    screen.sendBuffer();
+    if (settings.display.meters) screenMeters.start();
+    screenScheduler.setText(kTVOneStatusLine, tvOneStatusMessage.message());
+    screenScheduler.flush();
     
     //// CONTROLS TEST
 
     while (0) {
-        if (debug) debug->printf("xFade: %f, fadeOut: %f, tapLeft %i, tapRight: %i encPos: %i encChange:%i encHasPressed:%i \r\n" , xFadeAIN.read(), fadeUpAIN.read(), tapLeftDIN.read(), tapRightDIN.read(), menuEnc.getPos(), menuEnc.getChange(), menuEnc.hasPressed());
+        if (debug) debug->printf("xFade: %f, fadeOut: %f, tapLeft %i, tapRight: %i encPos: %i encChange:%i encHasPressed:%i \r\n" , faderSampler.position(0), faderSampler.position(1), tapLeftPin.isActive(), tapRightPin.isActive(), menuEnc.getPos(), menuChangePending, menuPressed);
     }
 
     //// MIXER RUN
@@ -1538,14 +2317,18 @@ int main()
             Net::poll();
         }
 
+        //// INPUT
+        
+        processInputEvents();
+        
         //// RJ45 SWITCH
         
-        if (rj45ModeDIN != rj45Mode)
+        if (rj45ModeInput != rj45Mode)
         {
             if (debug) debug->printf("Handling RJ45 mode change\r\n");   
 
             // update state
-            rj45Mode = rj45ModeDIN;
+            rj45Mode = rj45ModeInput;
             
             setCommsMenuItems();
             
@@ -1558,16 +2341,20 @@ int main()
             {
                 screen.clearBufferRow(kMenuLine1);
                 screen.clearBufferRow(kMenuLine2);
-                screen.textToBuffer(selectedMenu->title, kMenuLine1);
-                screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+                screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+                screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
             }
-            if (rj45Mode == rj45Ethernet) screen.textToBuffer("RJ45: Ethernet Mode", kCommsStatusLine);
-            if (rj45Mode == rj45DMX) screen.textToBuffer("RJ45: DMX Mode", kCommsStatusLine);
+            if (rj45Mode == rj45Ethernet) screenScheduler.setText(kCommsStatusLine, "RJ45: Ethernet Mode");
+            if (rj45Mode == rj45DMX) screenScheduler.setText(kCommsStatusLine, "RJ45: DMX Mode");
         }
 
         //// MENU
         
-        int menuChange = menuEnc.getChange();
+        // Handlers set the encoder's acceleration for what they adjust, menus are an item per detent
+        if (selectedMenu->selectedItem().type != SPKMenuItem::hasHandler) menuEnc.setAcceleration(kSPKEncoderAccelerationOff);
+        
+        int menuChange = menuChangePending;
+        menuChangePending = 0;
         
         // Update GUI
         if (menuChange != 0)
@@ -1584,15 +2371,17 @@ int main()
                 
                 // update OLED line 2 here
                 screen.clearBufferRow(kMenuLine2);
-                screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+                screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
                 
                 if (debug) debug->printf("%s \r\n", selectedMenu->selectedString().c_str());
             }    
         }
         
         // Action menu item
-        if (menuEnc.hasPressed()) 
+        if (menuPressed) 
         {
+            menuPressed = false;
+            
             if (debug) debug->printf("Action Menu Item!\r\n");
                     
             // Are we changing menus?
@@ -1610,8 +2399,8 @@ int main()
                 // update OLED lines 1&2
                 screen.clearBufferRow(kMenuLine1);
                 screen.clearBufferRow(kMenuLine2);
-                screen.textToBuffer(selectedMenu->title, kMenuLine1);
-                screen.textToBuffer(selectedMenu->selectedString(), kMenuLine2);
+                screen.labelToBuffer(selectedMenu->title, kMenuLine1);
+                screen.labelToBuffer(selectedMenu->selectedString(), kMenuLine2);
                 
                 if (selectedMenu->selectedItem().type == SPKMenuItem::hasHandler)
                 {
@@ -1634,7 +2423,17 @@ int main()
             {
                 int mixModeMenuPayload = mixModeMenu.selectedItem().payload.command[0];
 
-                if (mixModeMenuPayload < mixKeyPresetStartIndex)
+                if (mixModeMenuPayload >= mixCurveStartIndex)
+                {
+                    int curveIndex = (mixModeMenuPayload - mixCurveStartIndex) / 2;
+                    bool isFadeUp = (mixModeMenuPayload - mixCurveStartIndex) % 2;
+                    
+                    if (isFadeUp)   fadeUpCurveIndex = curveIndex;
+                    else            xFadeCurveIndex = curveIndex;
+                    
+                    tvOneStatusMessage.addMessage((isFadeUp ? "FadeUp curve: " : "XFade curve: ") + settings.faderCurveName(curveIndex), kTVOneStatusMessageHoldTime);
+                }
+                else if (mixModeMenuPayload < mixKeyPresetStartIndex)
                 {
                     mixMode = mixModeMenuPayload;
                     
@@ -1647,14 +2446,14 @@ int main()
                     if (keySetIndex > 0) // Key set 0 is now the "live" set, we read from processor rather than write to it.
                     {
                         bool ok;
-                        ok =       tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, settings.keyerParamSet(keySetIndex)[SPKSettings::minY]); 
-                        ok = ok && tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, settings.keyerParamSet(keySetIndex)[SPKSettings::maxY]); 
-                        ok = ok && tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, settings.keyerParamSet(keySetIndex)[SPKSettings::minU]); 
-                        ok = ok && tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, settings.keyerParamSet(keySetIndex)[SPKSettings::maxU]); 
-                        ok = ok && tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, settings.keyerParamSet(keySetIndex)[SPKSettings::minV]); 
-                        ok = ok && tvOne.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, settings.keyerParamSet(keySetIndex)[SPKSettings::maxV]);
+                        ok =       tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinY, settings.keyerParamSet(keySetIndex)[SPKSettings::minY]); 
+                        ok = ok && tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxY, settings.keyerParamSet(keySetIndex)[SPKSettings::maxY]); 
+                        ok = ok && tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinU, settings.keyerParamSet(keySetIndex)[SPKSettings::minU]); 
+                        ok = ok && tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxU, settings.keyerParamSet(keySetIndex)[SPKSettings::maxU]); 
+                        ok = ok && tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMinV, settings.keyerParamSet(keySetIndex)[SPKSettings::minV]); 
+                        ok = ok && tvOneCache.command(0, mixKeyWindow, kTV1FunctionAdjustKeyerMaxV, settings.keyerParamSet(keySetIndex)[SPKSettings::maxV]);
                         
-                        tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+                        tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
                         
                         tvOneStatusMessage.addMessage(ok ? "Loaded: " + settings.keyerParamName(keySetIndex) + " values" : "Send error: keyer values", kTVOneStatusMessageHoldTime);
                     }
@@ -1662,18 +2461,19 @@ int main()
             }
             else if (selectedMenu == &resolutionMenu)
             {
-                screen.clearBufferRow(kTVOneStatusLine);
-                screen.textToBuffer("Setting Resolution...", kTVOneStatusLine);
-                screen.sendBuffer();
+                screenScheduler.setText(kTVOneStatusLine, "Setting Resolution...");
+                screenScheduler.flush();
                 
                 bool ok;
-                int oldEDID = tvOne.getEDID();
+                int oldEDID = tvOneLibrary().getEDID();
                 int newEDID = tvOneEDIDPassthrough ? EDIDPassthroughSlot : resolutionMenu.selectedItem().payload.command[1];
                 
-                ok = tvOne.setResolution(resolutionMenu.selectedItem().payload.command[0], newEDID);
+                tvOneYieldToFades();
+                ok = tvOneLibrary().setResolution(resolutionMenu.selectedItem().payload.command[0], newEDID);
+                tvOneCache.invalidate();
                 
                 // Save new resolution and EDID into TV One unit for power-on. Cycling TV One power sometimes needed for EDID. Pffft.
-                if (ok) tvOne.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
+                if (ok) tvOneCache.command(0, kTV1WindowIDA, kTV1FunctionPowerOnPresetStore, 1);
                 
                 string message;
                 if (ok)
@@ -1813,8 +2613,7 @@ int main()
                     dmx = new DMX(kMBED_RS485_TTLTX, kMBED_RS485_TTLRX);
                 }
                                 
-                screen.clearBufferRow(kCommsStatusLine);
-                screen.textToBuffer(commsTypeString + commsStatusBuffer, kCommsStatusLine);
+                screenScheduler.setText(kCommsStatusLine, commsTypeString + commsStatusBuffer);
             }
             else if (selectedMenu == &advancedMenu)
             {
@@ -1822,19 +2621,20 @@ int main()
                 {
                     bool ok = true;
                 
-                    screen.clearBufferRow(kTVOneStatusLine);
-                    screen.textToBuffer("Uploading...", kTVOneStatusLine);
-                    screen.sendBuffer();
+                    screenScheduler.setText(kTVOneStatusLine, "Uploading...");
+                    screenScheduler.flush();
                     
                     ok = ok && uploadToProcessor();                    
                     
-                    screen.clearBufferRow(kTVOneStatusLine);
-                    screen.textToBuffer("Conforming...", kTVOneStatusLine);
-                    screen.sendBuffer();
+                    screenScheduler.setText(kTVOneStatusLine, "Conforming...");
+                    screenScheduler.flush();
                     
-                    ok = ok && conformProcessor();
+                    int skipped = 0;
+                    ok = ok && conformProcessor(&skipped);
                     
-                    std::string sendOK = ok ? "Conform success" : "Send Error: Conform";
+                    char sendOK[kStringBufferLength];
+                    if (ok) snprintf(sendOK, kStringBufferLength, "Conform OK, %i same", skipped);
+                    else    snprintf(sendOK, kStringBufferLength, "Send Error: Conform");
                     
                     tvOneStatusMessage.addMessage(sendOK, kTVOneStatusMessageHoldTime, 600);
                 }
@@ -1852,10 +2652,10 @@ int main()
             }
         }
 
-        // Send any updates to the display
-        screen.clearBufferRow(kTVOneStatusLine);
-        screen.textToBuffer(tvOneStatusMessage.message(), kTVOneStatusLine);
-        screen.sendBuffer();
+        // Send any updates to the display, at most at the frame rate
+        screenMeters.update(fadeAPercent, fadeBPercent);
+        screenScheduler.setText(kTVOneStatusLine, tvOneStatusMessage.message());
+        screenScheduler.update();
         
         //// MIX MIX MIX MIX MIX MIX MIX MIX MIX MIX MIX MIXMIX MIX MIXMIX MIX MIX MIX MIX MIXMIX MIX MIX
 
@@ -1863,185 +2663,21 @@ int main()
         float xFade = 0;
         float fadeUp = 1;
         
-        //// TASK: Process control surface
-        
-        // Get new states of tap buttons, remembering at end of loop() assign these current values to the previous variables
-        const bool tapLeft = !tapLeftDIN;
-        const bool tapRight = !tapRightDIN;
-        
-        // We're taking a further median of the AINs on top of mbed libs v29.
-        // This takes some values from last passes and most from now. With debug off, seem to need median size > 5
-        xFadeFilter.process(xFadeAIN.read());
-        fadeUpFilter.process(fadeUpAIN.read());
-        xFadeFilter.process(xFadeAIN.read());
-        fadeUpFilter.process(fadeUpAIN.read());
-        xFadeFilter.process(xFadeAIN.read());
-        fadeUpFilter.process(fadeUpAIN.read());
-        xFadeFilter.process(xFadeAIN.read());
-        fadeUpFilter.process(fadeUpAIN.read());
-        const float xFadeAINCached = xFadeFilter.process(xFadeAIN.read());
-        const float fadeUpAINCached = fadeUpFilter.process(fadeUpAIN.read());
-        
-        // When a tap is depressed, we can ignore any move of the crossfader but not fade to black
-        if (tapLeft || tapRight) 
-        {
-            // If both are pressed, take to the one that is new, ie. not the first pressed.
-            if (tapLeft && tapRight) 
-            {
-                xFade = tapLeftWasFirstPressed ? 1 : 0;
-            }
-            // If just one is pressed, take to that and remember which is pressed
-            else if (tapLeft) 
-            {
-                xFade = 0;
-                tapLeftWasFirstPressed = 1;
-            }
-            else if (tapRight) 
-            {
-                xFade = 1;
-                tapLeftWasFirstPressed = 0;
-            }
-        }
-        else xFade = 1.0 - fadeCalc(xFadeAINCached, xFadeTolerance);
-
-        fadeUp = 1.0 - fadeCalc(fadeUpAINCached, fadeUpTolerance);
-
-        //// TASK: Process Network Comms In, allowing hands-on controls to override
-        if ((commsMode == commsOSC) || (commsMode == commsArtNet) || (commsMode == commsDMXIn))
-        {
-            bool commsIn = false;
-
-            switch (commsMode)
-            {
-                case commsOSC:      commsIn = processOSCIn(); break;
-                case commsArtNet:   commsIn = processArtNetIn(); break;
-                case commsDMXIn:    commsIn = processDMXIn(); break;
-            }
-        
-            if (commsIn)
-            {
-                // Store hands-on control positions to compare for change later
-                commsInActive = true;
-                oldXFade = xFade;
-                oldFadeUp = fadeUp;
-            }
-            else if (commsInActive)
-            {
-                // If no comms in update this loop, hold to the last unless hands-on controls have moved significantly
-                bool movement = (fabs(oldXFade-xFade) > 0.1) || (fabs(oldFadeUp-fadeUp) > 0.1);
-                if (movement) 
-                {   
-                    commsInActive = false;
-                    commsXFade = -1;
-                    commsFadeUp = -1;
-                }
-            }
-        
-            if (commsInActive)
-            {
-                if (commsXFade >= 0)    xFade = commsXFade;
-                if (commsFadeUp >= 0)   fadeUp = commsFadeUp;   
-            }
-        }
-
-        // Calculate new A&B fade percents
-        int newFadeAPercent = 0;
-        int newFadeBPercent = 0;
-
-        if (mixMode == mixBlend) 
-        {
-            // This is the correct algorithm for blend where window A occludes B.
-            // Who knew a crossfade could be so tricky. The level of B has to be factored by what A is letting through.
-            // ie. if fully faded up, top window = xfade, bottom window = 100%
-            // This will however look very wrong if A is not occluding B, ie. mismatched aspect ratios.
-            if (xFade > 0) // avoids div by zero (if xFade = 0 and fadeUp = 1, B sum = 0 / 0)
-            {
-                newFadeAPercent = (1.0-xFade) * fadeUp * 100.0;
-                newFadeBPercent = (xFade*fadeUp) / (1.0 - fadeUp + xFade*fadeUp) * 100.0;
-            }
-            else
-            {
-                newFadeAPercent = fadeUp * 100.0;
-                newFadeBPercent = 0;
-            }
-        }
-        else if (mixMode == mixAdditive)
-        {
-            // we need to set fade level of both windows according to the fade curve profile
-            float newFadeA = (1.0-xFade) * (1.0 + fadeCurve);
-            float newFadeB = xFade * (1 + fadeCurve);
-            if (newFadeA > 1.0) newFadeA = 1.0;
-            if (newFadeB > 1.0) newFadeB = 1.0;
-            
-            newFadeAPercent = newFadeA * fadeUp * 100.0;
-            newFadeBPercent = newFadeB * fadeUp * 100.0;
-        }
-        else if (mixMode == mixKeyLeft)
-        {
-            newFadeAPercent = (1.0-xFade) * fadeUp * 100.0;
-            newFadeBPercent = fadeUp * 100.0;
-        }
-        else if (mixMode == mixKeyRight)
-        {
-            newFadeAPercent = fadeUp * 100.0;
-            newFadeBPercent = xFade * fadeUp * 100.0;
-        }
-        
-        //// TASK: Send to TVOne if percents have changed
-        
-        // No amount of median filtering is stopping flipflopping between two adjacent percents, so...
-        bool fadeAPercentHasChanged;
-        bool fadeBPercentHasChanged;
-        if (oldFadeAPercent == newFadeAPercent && (newFadeAPercent == fadeAPercent - 1 || newFadeAPercent == fadeAPercent + 1))
-            fadeAPercentHasChanged = false;
-        else
-            fadeAPercentHasChanged = newFadeAPercent != fadeAPercent;
-        if (oldFadeBPercent == newFadeBPercent && (newFadeBPercent == fadeBPercent - 1 || newFadeBPercent == fadeBPercent + 1))
-            fadeBPercentHasChanged = false;
-        else
-            fadeBPercentHasChanged = newFadeBPercent != fadeBPercent;
-        
         // If changing mixMode from additive, we want to do this before updating fade values
         if (mixMode != mixModeOld && mixModeOld == mixAdditive) actionMixMode();
         
-        // We want to send the higher first, otherwise black flashes can happen on taps
-        if (fadeAPercentHasChanged && newFadeAPercent >= newFadeBPercent) 
-        {
-            oldFadeAPercent = fadeAPercent;
-            fadeAPercent = newFadeAPercent;
-            updateFade = true;
-            
-            fadeAPO = fadeAPercent / 100.0;
-            tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeAPercent);
-        }
-        if (fadeBPercentHasChanged) 
-        {
-            oldFadeBPercent = fadeBPercent;
-            fadeBPercent = newFadeBPercent;
-            updateFade = true;
-            
-            fadeBPO = fadeBPercent / 100.0;
-            tvOne.command(0, kTV1WindowIDB, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeBPercent);
-        }
-        if (fadeAPercentHasChanged && newFadeAPercent < newFadeBPercent) 
-        {
-            oldFadeAPercent = fadeAPercent; 
-            fadeAPercent = newFadeAPercent;
-            updateFade = true;
-            
-            fadeAPO = fadeAPercent / 100.0;
-            tvOne.command(0, kTV1WindowIDA, kTV1FunctionAdjustWindowsMaxFadeLevel, fadeAPercent);
-        }
-        if (updateFade && debug) 
+        updateFade = processMix(xFade, fadeUp);
+        
+        // If changing mixMode to additive, we want to do this after updating fade values
+        if (mixMode != mixModeOld) 
         {
-            //debug->printf("xFade = %3f   fadeUp = %3f \r\n", xFadeAIN.read(), fadeUpAIN.read());
-            debug->printf("xFade = %3f   fadeUp = %3f \r\n", xFadeAINCached, fadeUpAINCached);
-            debug->printf("xFade = %3f   fadeUp = %3f   fadeA% = %i   fadeB% = %i \r\n", xFade, fadeUp, fadeAPercent, fadeBPercent);
-            debug->printf("\r\n"); 
+            tvOneQueue.flush();
+            actionMixMode();
         }
         
-        // If changing mixMode to additive, we want to do this after updating fade values
-        if (mixMode != mixModeOld) actionMixMode();
+        //// TASK: Send to TVOne, one command per pass so controls are sampled and the display updated while the link drains
+        tvOneCache.poll();
+        tvOneQueue.service();
                 
         //// TASK: Process Network Comms Out, ie. send out any fade updates
         if (commsMode == commsOSC && updateFade && !commsInActive)
@@ -2061,13 +2697,20 @@ int main()
         
         //// TASK: Housekeeping
         
-        if (tvOne.millisSinceLastCommandSent() > tvOne.getCommandTimeoutPeriod() + 1000)
+        // One step per pass, and none while there are fades or edits to send. 
+        // So at worst a fader move waits for a single status read.
+        if (tvOneQueue.isClearFor(SPKTVOneQueue::priorityHousekeeping))
         {
-            // Lets check on our sources
-            handleTVOneSources();
+            int linkIdleMillis = tvOne.millisSinceLastCommandSent();
+            if (tvOneAsync.millisSinceLastCommandSent() < linkIdleMillis) linkIdleMillis = tvOneAsync.millisSinceLastCommandSent();
+            
+            if (housekeepingStep == housekeepingIdle && linkIdleMillis > tvOnePacing.commandTimeoutMillis() + 1000)
+            {
+                // Lets check on our sources, then our mix mode and fade levels
+                startHousekeeping(housekeepingRGB1Stable, housekeepingVerifyCache);
+            }
             
-            // Lets check on our fade levels
-            checkTVOneMixStatus();
+            stepHousekeeping();
         }
     }
 }
\ No newline at end of file
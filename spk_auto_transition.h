@@ -0,0 +1,107 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_AUTO_TRANSITION runs the crossfader from one position to another over a set time, through an SPKFaderCurve.
+// Steps are made by a Ticker interrupt at the rate given, so their timing doesn't depend on how long the main loop takes.
+// Once there, the transition holds the end position until cancelled, so the mix doesn't jump back to where the fader was left.
+// It also spots a double-tap of the tap buttons from their press times, which is one way to start one.
+
+#ifndef SPK_AUTO_TRANSITION_h
+#define SPK_AUTO_TRANSITION_h
+
+#include "mbed.h"
+
+#define kAutoTransitionDoubleTapMillis  350
+#define kAutoTransitionMinPeriodMillis  5
+
+class SPKAutoTransition {
+public:
+    SPKAutoTransition()
+    {
+        curve = NULL;
+        running = false;
+        active = false;
+        current = 0;
+        lastTapMicros = uint32_t(-kAutoTransitionDoubleTapMillis * 1000);
+    }
+
+    // Positions as 0-65536. A NULL curve is linear.
+    void start(int32_t from, int32_t to, int durationMillis, int periodMillis, SPKFaderCurve *transitionCurve = NULL)
+    {
+        ticker.detach();
+
+        fromPosition = from;
+        toPosition = to;
+        durationMicros = (durationMillis > 0 ? durationMillis : 1) * 1000;
+        curve = transitionCurve;
+        startMicros = clock.micros();
+        current = from;
+        active = true;
+        running = true;
+
+        if (periodMillis < kAutoTransitionMinPeriodMillis) periodMillis = kAutoTransitionMinPeriodMillis;
+        ticker.attach_us(this, &SPKAutoTransition::step, periodMillis * 1000);
+    }
+
+    void cancel()
+    {
+        ticker.detach();
+        running = false;
+        active = false;
+    }
+
+    // Running, or holding the end position
+    bool isActive()     { return active; }
+    bool isRunning()    { return running; }
+
+    // The latest step, 0-65536
+    int32_t position()  { return current; }
+
+    // Call with the time of each tap button press, on any one clock. Returns true if it's the second press of a double-tap.
+    bool tap(uint32_t pressMicros)
+    {
+        bool doubleTap = (pressMicros - lastTapMicros) < kAutoTransitionDoubleTapMillis * 1000;
+
+        // A third press starts counting again
+        lastTapMicros = doubleTap ? pressMicros - kAutoTransitionDoubleTapMillis * 1000 : pressMicros;
+
+        return doubleTap;
+    }
+
+private:
+    void step()
+    {
+        uint32_t elapsed = clock.micros() - startMicros;
+
+        int32_t progress = 65536;
+        if (elapsed < durationMicros) progress = int32_t((uint64_t(elapsed) << 16) / durationMicros);
+
+        if (curve) progress = curve->apply(progress);
+
+        current = fromPosition + int32_t((int64_t(toPosition - fromPosition) * progress) >> 16);
+
+        if (elapsed >= durationMicros)
+        {
+            current = toPosition;
+            running = false;
+            ticker.detach();
+        }
+    }
+
+    Ticker ticker;
+    SPKClock clock;
+    SPKFaderCurve *curve;
+
+    int32_t fromPosition;
+    int32_t toPosition;
+    uint32_t durationMicros;
+    uint32_t startMicros;
+    uint32_t lastTapMicros;
+
+    volatile int32_t current;
+    volatile bool running;
+    bool active;
+};
+
+#endif
@@ -0,0 +1,195 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_FADER_CURVE maps a fader's position through a response curve, eg. an S-curve or a cut.
+// Smooth shapes are compiled into a table when the settings are loaded, so applying one is a table lookup and a linear interpolation.
+// Shapes are linear, S, log, cut, or a list of breakpoints as input:output percent pairs, with straight lines between.
+// A breakpoint input given twice makes a step, so "0:0, 10:0, 10:100, 100:100" cuts at 10%.
+// Breakpoints and cuts are kept as points and applied exactly, as a table would interpolate a step into a ramp a table entry wide.
+
+#ifndef SPK_FADER_CURVE_h
+#define SPK_FADER_CURVE_h
+
+#include "mbed.h"
+#include <string>
+#include <math.h>
+
+#define kSPKFaderCurveTableBits     6
+#define kSPKFaderCurveTableSize     ((1 << kSPKFaderCurveTableBits) + 1)
+#define kSPKFaderCurveTableShift    (16 - kSPKFaderCurveTableBits)
+#define kSPKFaderCurveMaxPoints     16
+#define kSPKFaderCurveLogBase       9.0f // log(1 + 9x) / log(10), so 0 and 1 map to themselves
+
+class SPKFaderCurve {
+public:
+    enum faderType { faderXFade = 1, faderFadeUp = 2, faderBoth = 3 };
+
+    SPKFaderCurve(string curveName = "Linear", faderType curveFader = faderBoth)
+    {
+        name = curveName;
+        fader = curveFader;
+        compileLinear();
+    }
+
+    string name;
+    faderType fader;
+
+    // Position and result as 0-65536
+    int32_t apply(int32_t position)
+    {
+        if (pointCount > 0) return applyPoints(position);
+
+        if (position <= 0) return table[0];
+        if (position >= 65536) return table[kSPKFaderCurveTableSize - 1];
+
+        int i = position >> kSPKFaderCurveTableShift;
+        int32_t fraction = position & ((1 << kSPKFaderCurveTableShift) - 1);
+
+        return table[i] + (((table[i+1] - table[i]) * fraction) >> kSPKFaderCurveTableShift);
+    }
+
+    bool appliesTo(faderType curveFader)
+    {
+        return fader & curveFader;
+    }
+
+    // As the settings file has it: XFade, FadeUp or Both. Returns false if it's none of those.
+    bool setFader(const char *faderName)
+    {
+        if      (!strcasecmp(faderName, "XFade"))   fader = faderXFade;
+        else if (!strcasecmp(faderName, "FadeUp"))  fader = faderFadeUp;
+        else if (!strcasecmp(faderName, "Both"))    fader = faderBoth;
+        else return false;
+        return true;
+    }
+
+    // As the settings file has it: points if given, otherwise the shape, Linear, S, Log or Cut at the threshold percent.
+    // Returns false if that doesn't make a curve.
+    bool compile(const char *shape, const char *points, int thresholdPercent)
+    {
+        if (points)                         return compilePoints(points);
+        if (!strcasecmp(shape, "Linear"))   compileLinear();
+        else if (!strcasecmp(shape, "S"))   compileS();
+        else if (!strcasecmp(shape, "Log")) compileLog();
+        else if (!strcasecmp(shape, "Cut"))
+        {
+            if (thresholdPercent < 0 || thresholdPercent > 100) return false;
+            compileCut(thresholdPercent);
+        }
+        else return false;
+        return true;
+    }
+
+    void compileLinear()
+    {
+        pointCount = 0;
+        for (int i=0; i < kSPKFaderCurveTableSize; i++) table[i] = i << kSPKFaderCurveTableShift;
+    }
+
+    // Smoothstep, slow out of and into the ends
+    void compileS()
+    {
+        pointCount = 0;
+        for (int i=0; i < kSPKFaderCurveTableSize; i++)
+        {
+            float x = inputAt(i);
+            store(i, x * x * (3.0f - 2.0f * x));
+        }
+    }
+
+    // Fast out of zero, as an audio fader's log taper
+    void compileLog()
+    {
+        pointCount = 0;
+        for (int i=0; i < kSPKFaderCurveTableSize; i++)
+        {
+            store(i, logf(1.0f + kSPKFaderCurveLogBase * inputAt(i)) / logf(1.0f + kSPKFaderCurveLogBase));
+        }
+    }
+
+    // Nothing until the threshold percent, then all
+    void compileCut(int thresholdPercent)
+    {
+        int inputs[] = {0, thresholdPercent, thresholdPercent, 100};
+        int outputs[] = {0, 0, 100, 100};
+        for (int i=0; i < 4; i++) addPoint(i, inputs[i], outputs[i]);
+        pointCount = 4;
+    }
+
+    // As "in:out, in:out, ..." in percent, inputs ascending. Returns false if it doesn't parse.
+    // The curve is left as it was if not.
+    bool compilePoints(const char *points)
+    {
+        int inputs[kSPKFaderCurveMaxPoints];
+        int outputs[kSPKFaderCurveMaxPoints];
+        int count = 0;
+
+        const char *c = points;
+        while (count < kSPKFaderCurveMaxPoints)
+        {
+            int in, out, length;
+            if (sscanf(c, " %d : %d%n", &in, &out, &length) != 2) break;
+            if (in < 0 || in > 100 || out < 0 || out > 100) return false;
+            if (count > 0 && in < inputs[count-1]) return false;
+
+            inputs[count] = in;
+            outputs[count] = out;
+            count++;
+
+            c += length;
+            while (*c == ' ' || *c == ',') c++;
+        }
+
+        if (count < 2) return false;
+
+        for (int i=0; i < count; i++) addPoint(i, inputs[i], outputs[i]);
+        pointCount = count;
+
+        return true;
+    }
+
+private:
+    void addPoint(int i, int inputPercent, int outputPercent)
+    {
+        pointInputs[i] = (inputPercent * 65536 + 50) / 100;
+        pointOutputs[i] = (outputPercent * 65536 + 50) / 100;
+    }
+
+    int32_t applyPoints(int32_t position)
+    {
+        if (position < 0) position = 0;
+        if (position > 65536) position = 65536;
+
+        // The last segment starting at or before the position, so a repeated input steps at that input
+        int segment = 0;
+        while (segment < pointCount - 2 && pointInputs[segment+1] <= position) segment++;
+
+        int32_t x0 = pointInputs[segment], x1 = pointInputs[segment+1];
+        int32_t y0 = pointOutputs[segment], y1 = pointOutputs[segment+1];
+
+        // A step's segment has x0 == x1, and is at its top from the input on
+        if (position >= x1) return y1;
+        if (position <= x0) return y0;
+        return y0 + int32_t(int64_t(y1 - y0) * (position - x0) / (x1 - x0));
+    }
+
+    float inputAt(int i)
+    {
+        return float(i) / (kSPKFaderCurveTableSize - 1);
+    }
+
+    void store(int i, float value)
+    {
+        if (value < 0) value = 0;
+        if (value > 1) value = 1;
+        table[i] = int32_t(value * 65536 + 0.5f);
+    }
+
+    int32_t table[kSPKFaderCurveTableSize];
+    int32_t pointInputs[kSPKFaderCurveMaxPoints];
+    int32_t pointOutputs[kSPKFaderCurveMaxPoints];
+    int pointCount;
+};
+
+#endif
@@ -0,0 +1,264 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_FADER_SAMPLER samples the fader pots at a fixed rate, independent of how long the main loop takes.
+// The LPC1768 ADC runs in burst mode, converting the fader channels continuously in hardware.
+// A Ticker interrupt takes the latest conversion of each at the sample rate, into a ring buffer of timestamped samples, and through an SPKFaderFilter.
+// The filtered position and when it was sampled can then be had at any time, without waiting on the ADC.
+// Once started, AnalogIn::read() must not be used, as it would take the ADC out of burst mode.
+//
+// SPKFaderFilter is an exponential moving average with a deadband, O(1) per sample in integer maths.
+// SPKPercentHysteresis holds a percent until the value moves a set distance beyond it, so a fader at rest doesn't flip between adjacent percents.
+// SPKFaderPredictor extrapolates a moving fader to where it will be when a command sent now takes effect, from the slope of the raw samples.
+
+#ifndef SPK_FADER_SAMPLER_h
+#define SPK_FADER_SAMPLER_h
+
+#include "mbed.h"
+
+#define kSPKFaderSamplerCount       2
+#define kSPKFaderSamplerBufferSize  32 // Must be a power of two
+#define kSPKFaderSamplerRateHz      1000
+#define kSPKFaderFilterShift        3  // EMA weight of 1/8, so at 1kHz a time constant of 8ms
+#define kSPKFaderFilterDeadband     40 // In 1/65536ths of full scale, so two and a half ADC steps
+#define kSPKFaderPredictorWindow    16 // Samples to take the slope over, so 16ms at 1kHz
+#define kSPKFaderPredictorDeadband  8  // ADC steps over the window below which the fader is taken as still
+#define kSPKFaderPredictorRecent    4  // Samples to tell where the fader is heading from, so it is seen to stop within 4ms
+
+class SPKFaderFilter {
+public:
+    SPKFaderFilter(int shift = kSPKFaderFilterShift, int deadband = kSPKFaderFilterDeadband)
+    {
+        weightShift = shift;
+        deadbandQ16 = deadband;
+        accumulator = -1;
+        output = 0;
+    }
+
+    // Takes a 12-bit ADC value, returns position as 0-65536
+    int32_t process(uint16_t value)
+    {
+        int32_t scaled = int32_t(value) << 16;
+
+        if (accumulator < 0) accumulator = scaled;
+        else
+        {
+            // The shift rounds down, which reaches the bottom but stops short of the top, so round rising steps up
+            int32_t step = scaled - accumulator;
+            if (step > 0) step += (1 << weightShift) - 1;
+            accumulator += step >> weightShift;
+        }
+
+        int32_t position = accumulator / 4095;
+
+        int32_t difference = position - output;
+        if (difference > deadbandQ16 || difference < -deadbandQ16) output = position;
+
+        // The ends should always be reachable
+        if (position == 0 || position == 65536) output = position;
+
+        return output;
+    }
+
+private:
+    int weightShift;
+    int32_t deadbandQ16;
+    int32_t accumulator;
+    int32_t output;
+};
+
+class SPKPercentHysteresis {
+public:
+    SPKPercentHysteresis(float bandPercent)
+    {
+        band = int32_t(bandPercent * 65536);
+        held = 0;
+    }
+
+    // Takes the exact percent as 16.16 fixed point, returns the whole percent to use
+    int process(int32_t percent)
+    {
+        if (percent <= 0)
+        {
+            held = 0;
+        }
+        else if (percent >= (100 << 16))
+        {
+            held = 100;
+        }
+        else if (percent < (held << 16) - band || percent >= ((held + 1) << 16) + band)
+        {
+            held = percent >> 16;
+        }
+
+        return held;
+    }
+
+private:
+    int32_t band;
+    int held;
+};
+
+class SPKFaderSampler {
+public:
+    struct sampleType { uint16_t value; uint32_t micros; };
+
+    // Channels are the ADC's, ie. AD0.5 for p20. Construct AnalogIns on the pins first to set them up as analogue inputs.
+    SPKFaderSampler(int channel0, int channel1)
+    {
+        channels[0] = channel0;
+        channels[1] = channel1;
+
+        for (int i=0; i < kSPKFaderSamplerCount; i++)
+        {
+            positions[i] = 0;
+            positionMicros[i] = 0;
+            sampleCounts[i] = 0;
+        }
+    }
+
+    void start(int rateHz = kSPKFaderSamplerRateHz)
+    {
+        // Keep the clock divider and power as AnalogIn set them, select our channels, no start bits, burst on
+        uint32_t adcr = LPC_ADC->ADCR & ((0xFF << 8) | (1 << 21));
+        for (int i=0; i < kSPKFaderSamplerCount; i++) adcr |= 1 << channels[i];
+        adcr |= 1 << 16;
+        LPC_ADC->ADCR = adcr;
+
+        ticker.attach_us(this, &SPKFaderSampler::sample, 1000000 / rateHz);
+    }
+
+    void stop()
+    {
+        ticker.detach();
+        LPC_ADC->ADCR &= ~(1 << 16);
+    }
+
+    // Filtered, 0-1 as AnalogIn::read()
+    float position(int fader)
+    {
+        return positions[fader] / 65536.0f;
+    }
+
+    // Filtered, 0-65536
+    int32_t positionQ16(int fader)
+    {
+        return positions[fader];
+    }
+
+    // Filtered position, with the time of its latest sample on micros()
+    float position(int fader, uint32_t &micros)
+    {
+        __disable_irq();
+        int32_t value = positions[fader];
+        micros = positionMicros[fader];
+        __enable_irq();
+        return value / 65536.0f;
+    }
+
+    // Raw samples, age 0 the newest. Returns false if there aren't that many yet.
+    bool sampleAt(int fader, int age, sampleType &sample)
+    {
+        if (age >= kSPKFaderSamplerBufferSize) return false;
+
+        __disable_irq();
+        uint32_t count = sampleCounts[fader];
+        bool ok = (uint32_t(age) < count);
+        if (ok) sample = samples[fader][(count - 1 - age) & (kSPKFaderSamplerBufferSize - 1)];
+        __enable_irq();
+
+        return ok;
+    }
+
+    uint32_t micros()
+    {
+        return clock.micros();
+    }
+
+private:
+    void sample()
+    {
+        uint32_t now = clock.micros();
+
+        for (int i=0; i < kSPKFaderSamplerCount; i++)
+        {
+            uint32_t result = (&LPC_ADC->ADDR0)[channels[i]];
+
+            // Done bit, otherwise there's been no conversion since we last looked
+            if (!(result & (1UL << 31))) continue;
+
+            uint16_t value = (result >> 4) & 0xFFF;
+
+            sampleType &newSample = samples[i][sampleCounts[i] & (kSPKFaderSamplerBufferSize - 1)];
+            newSample.value = value;
+            newSample.micros = now;
+            sampleCounts[i]++;
+
+            positions[i] = filters[i].process(value);
+            positionMicros[i] = now;
+        }
+    }
+
+    Ticker ticker;
+    SPKClock clock;
+    int channels[kSPKFaderSamplerCount];
+    SPKFaderFilter filters[kSPKFaderSamplerCount];
+
+    sampleType samples[kSPKFaderSamplerCount][kSPKFaderSamplerBufferSize];
+    volatile uint32_t sampleCounts[kSPKFaderSamplerCount];
+    volatile int32_t positions[kSPKFaderSamplerCount];
+    volatile uint32_t positionMicros[kSPKFaderSamplerCount];
+};
+
+class SPKFaderPredictor {
+public:
+    SPKFaderPredictor(SPKFaderSampler *faderSampler)
+    {
+        sampler = faderSampler;
+    }
+
+    // Filtered position 0-65536, moved on by the fader's current velocity over leadMillis.
+    // The filter's own lag is added to the lead. Never beyond the ends, so a slam to either is not overshot.
+    // Nor beyond where the newest few samples say the fader is heading, so a fader stopping mid-travel is not overshot and sprung back from.
+    int32_t position(int fader, int leadMillis)
+    {
+        int32_t position = sampler->positionQ16(fader);
+
+        SPKFaderSampler::sampleType newest, recent, oldest;
+        if (!sampler->sampleAt(fader, 0, newest) || !sampler->sampleAt(fader, kSPKFaderPredictorRecent, recent) || !sampler->sampleAt(fader, kSPKFaderPredictorWindow, oldest)) return position;
+
+        int32_t steps = int32_t(newest.value) - int32_t(oldest.value);
+        int32_t micros = newest.micros - oldest.micros;
+        if (steps <= kSPKFaderPredictorDeadband && steps >= -kSPKFaderPredictorDeadband) return position;
+        if (micros <= 0) return position;
+
+        // An EMA of weight 1/2^n trails a steady move by 2^n - 1 samples
+        int32_t leadMicros = leadMillis * 1000 + ((1 << kSPKFaderFilterShift) - 1) * (1000000 / kSPKFaderSamplerRateHz);
+
+        int64_t predicted = position + (int64_t(steps) * 65536 * leadMicros) / (int64_t(4095) * micros);
+
+        // Between where the fader is now and where it's heading, which is where it is if it has stopped
+        int32_t current = (int32_t(newest.value) * 65536 + 2047) / 4095;
+        int64_t heading = current;
+        int32_t recentSteps = int32_t(newest.value) - int32_t(recent.value);
+        int32_t recentMicros = newest.micros - recent.micros;
+        bool stillMoving = (steps > 0) ? (recentSteps > kSPKFaderPredictorDeadband/2) : (recentSteps < -kSPKFaderPredictorDeadband/2);
+        if (stillMoving && recentMicros > 0) heading += (int64_t(recentSteps) * 65536 * leadMillis * 1000) / (int64_t(4095) * recentMicros);
+
+        int64_t low = (heading < current) ? heading : current;
+        int64_t high = (heading < current) ? current : heading;
+        if (predicted < low) predicted = low;
+        if (predicted > high) predicted = high;
+
+        if (predicted < 0) predicted = 0;
+        if (predicted > 65536) predicted = 65536;
+
+        return int32_t(predicted);
+    }
+
+private:
+    SPKFaderSampler *sampler;
+};
+
+#endif
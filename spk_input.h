@@ -0,0 +1,129 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_INPUT timestamps control surface input as it happens, rather than when the main loop gets round to polling.
+// SPKInputQueue is a lock-free ring of input events, for the tap buttons, encoder and RJ45 mode pin alike.
+// Interrupts push, the main loop pops, so events arrive in the order they happened and none are lost unless the ring fills.
+// It's single producer: every pushing interrupt is at the same NVIC priority, so none preempts another.
+// SPKInputPin takes a pin's edges by interrupt, debounces them, and pushes an event for each change of level.
+
+#ifndef SPK_INPUT_h
+#define SPK_INPUT_h
+
+#include "mbed.h"
+
+#define kSPKInputQueueSize          32 // Must be a power of two
+#define kSPKInputPinDebounceMicros  5000
+
+class SPKInputQueue {
+public:
+    enum sourceType { inputTapLeft, inputTapRight, inputEncoderTurn, inputEncoderPress, inputRJ45Mode };
+
+    struct eventType {
+        uint8_t  source;
+        int16_t  value;
+        uint32_t micros;
+    };
+
+    SPKInputQueue()
+    {
+        head = 0;
+        tail = 0;
+        overflows = 0;
+    }
+
+    // Interrupt side. Timestamps the event now. Returns false if the main loop has fallen a whole ring behind.
+    bool push(sourceType source, int value)
+    {
+        uint32_t next = (head + 1) & (kSPKInputQueueSize - 1);
+        if (next == tail)
+        {
+            overflows++;
+            return false;
+        }
+
+        events[head].source = source;
+        events[head].value = value;
+        events[head].micros = clock.micros();
+        head = next;
+
+        return true;
+    }
+
+    // Main loop side
+    bool pop(eventType &event)
+    {
+        if (tail == head) return false;
+
+        event = events[tail];
+        tail = (tail + 1) & (kSPKInputQueueSize - 1);
+
+        return true;
+    }
+
+    // On the same clock as event timestamps
+    uint32_t micros()       { return clock.micros(); }
+    int overflowCount()     { return overflows; }
+
+private:
+    SPKClock clock;
+    eventType events[kSPKInputQueueSize];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile int overflows;
+};
+
+class SPKInputPin {
+public:
+    // Pushes the pin's state as it is now, then an event for each change. Buttons are wired active low.
+    SPKInputPin(PinName pin, SPKInputQueue *inputQueue, SPKInputQueue::sourceType inputSource, bool isActiveLow = true) : interrupt(pin)
+    {
+        queue = inputQueue;
+        source = inputSource;
+        activeLow = isActiveLow;
+        lastEdgeMicros = queue->micros() - kSPKInputPinDebounceMicros;
+
+        active = (interrupt.read() != 0) != activeLow;
+        queue->push(source, active ? 1 : 0);
+
+        interrupt.fall(this, &SPKInputPin::onEdge);
+        interrupt.rise(this, &SPKInputPin::onEdge);
+    }
+
+    // Debounced state, as of the last edge
+    bool isActive() { return active; }
+
+    // A change back inside the debounce time has no edge after it to be seen by, so call this from the main loop to catch up
+    void poll()
+    {
+        __disable_irq();
+        onEdge();
+        __enable_irq();
+    }
+
+private:
+    void onEdge()
+    {
+        uint32_t now = queue->micros();
+
+        // Contact bounce is a burst of edges, so once one has been taken ignore the rest
+        if (now - lastEdgeMicros < kSPKInputPinDebounceMicros) return;
+
+        bool state = (interrupt.read() != 0) != activeLow;
+        if (state == active) return;
+
+        lastEdgeMicros = now;
+        active = state;
+        queue->push(source, state ? 1 : 0);
+    }
+
+    InterruptIn interrupt;
+    SPKInputQueue *queue;
+    SPKInputQueue::sourceType source;
+    bool activeLow;
+    volatile bool active;
+    uint32_t lastEdgeMicros;
+};
+
+#endif
@@ -5,28 +5,51 @@
 // spkRotaryEncoder extends mRotaryEncoder to return the change on pot state since last queried
 // This allows the encoder to be polled when the host program is ready, and return info suitable for driving a TVOne style menu
 // Importantly to driving such a menu, it will ignore any further rotation after the switch is pressed.
+// Turning quickly can be made to count for more, so long ranges don't take many turns: see setAcceleration().
+// Detents are timed in the rotation interrupt, so the rate is measured as turned, not as polled.
+// Given an SPKInputQueue, turns and presses are pushed to it as events instead of being kept for getChange() and hasPressed().
 
 #include "mRotaryEncoder.h"
 
+#define kSPKEncoderAccelerationOff      1
+#define kSPKEncoderSlowDetentMicros     100000 // Turning slower than this is one step per detent
+#define kSPKEncoderFastDetentMicros     10000  // Turning faster than this is the most steps per detent
+
 class SPKRotaryEncoder : public mRotaryEncoder {
 
 public:
     bool    hasPressed();
     int     getChange();
     int     getPos(); // This would be a Get() override, but its not virtual. We use this instead to correct for positions-per-detent
+    void    setAcceleration(int maxStepsPerDetent); // Steps per detent at full speed, rising with the square of the speed. 1 is off.
+    void    setQueue(SPKInputQueue *inputQueue);
     SPKRotaryEncoder(PinName pinA, PinName pinB, PinName pinSW, PinMode pullMode=PullUp, int debounceTime_us=1000);
 
 private:
     void    onPress();
-    bool    m_hasPressed;
-    int     m_positionOld;
-    int     m_positionOnPress;
+    void    onRotate();
+    volatile bool m_hasPressed;
+    int     m_detentOld;
+    volatile int m_change;
+    int     m_acceleration;
+    uint32_t m_lastDetentMicros;
+    SPKInputQueue *m_queue;
+    Timer   m_timer;
 
 };
 
 SPKRotaryEncoder::SPKRotaryEncoder(PinName pinA, PinName pinB, PinName pinSW, PinMode pullMode, int debounceTime_us) : mRotaryEncoder(pinA, pinB, pinSW, pullMode, debounceTime_us)
 {
+    m_hasPressed = false;
+    m_detentOld = 0;
+    m_change = 0;
+    m_acceleration = kSPKEncoderAccelerationOff;
+    m_lastDetentMicros = 0;
+    m_queue = NULL;
+    m_timer.start();
+    
     attachSW(this,&SPKRotaryEncoder::onPress);
+    attachROT(this,&SPKRotaryEncoder::onRotate);
 }
 
 bool SPKRotaryEncoder::hasPressed()
@@ -39,16 +62,24 @@ bool SPKRotaryEncoder::hasPressed()
 
 int SPKRotaryEncoder::getChange()
 {
-    int positionEnc = this->getPos();
-        
-    int positionToUse = m_hasPressed ? m_positionOnPress : positionEnc;
-    int change = positionToUse - m_positionOld;
-    
-    m_positionOld = positionEnc;
+    __disable_irq();
+    int change = m_change;
+    m_change = 0;
+    __enable_irq();
 
     return change;
 }
 
+void SPKRotaryEncoder::setQueue(SPKInputQueue *inputQueue)
+{
+    m_queue = inputQueue;
+}
+
+void SPKRotaryEncoder::setAcceleration(int maxStepsPerDetent)
+{
+    m_acceleration = maxStepsPerDetent < 1 ? 1 : maxStepsPerDetent;
+}
+
 int SPKRotaryEncoder::getPos()
 {
     int positionEnc = this->Get();
@@ -59,6 +90,34 @@ int SPKRotaryEncoder::getPos()
 
 void SPKRotaryEncoder::onPress()
 {
-    m_positionOnPress = this->getPos();
-    m_hasPressed = true;
+    if (m_queue) m_queue->push(SPKInputQueue::inputEncoderPress, 1);
+    else m_hasPressed = true;
+}
+
+void SPKRotaryEncoder::onRotate()
+{
+    int positionEnc = this->getPos();
+    if (positionEnc == m_detentOld) return;
+    
+    int detents = positionEnc - m_detentOld;
+    m_detentOld = positionEnc;
+    
+    // Rotation after a press is ignored until the press is taken
+    if (m_hasPressed) return;
+    
+    uint32_t now = m_timer.read_us();
+    uint32_t interval = now - m_lastDetentMicros;
+    m_lastDetentMicros = now;
+    
+    int steps = 1;
+    if (m_acceleration > 1 && interval < kSPKEncoderSlowDetentMicros)
+    {
+        // Speed as 0-256 between slow and fast, then squared, so a gentle turn stays fine
+        int32_t speed = ((kSPKEncoderSlowDetentMicros - int32_t(interval)) << 8) / (kSPKEncoderSlowDetentMicros - kSPKEncoderFastDetentMicros);
+        if (speed > 256) speed = 256;
+        steps = 1 + (((m_acceleration - 1) * speed * speed) >> 16);
+    }
+    
+    if (m_queue) m_queue->push(SPKInputQueue::inputEncoderTurn, detents * steps);
+    else m_change += detents * steps;
 }
\ No newline at end of file
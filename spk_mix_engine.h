@@ -0,0 +1,183 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_MIX_ENGINE resolves the crossfader and fade-to-black positions to the A and B window fade percents, in integer maths.
+// The LPC1768 has no FPU, so the float and double mix formulas this replaces cost a soft-float division and several multiplies every pass.
+// Positions are taken as 0-65536, and percents returned as 0-100 in 16.16 fixed point.
+// The whole percent of each result is exactly what the float formulas truncate to for the same positions.
+// Where those formulas round to float precision, that rounding is reproduced rather than approximated, see roundToFloat().
+
+#ifndef SPK_MIX_ENGINE_h
+#define SPK_MIX_ENGINE_h
+
+#include "mbed.h"
+
+#define kSPKMixEngineOne            65536
+#define kSPKMixEnginePercentOne     (100 << 16)
+
+class SPKMixEngine {
+public:
+    SPKMixEngine()
+    {
+        setFadeCurve(0.0f);
+    }
+
+    // As set in the mix mode menu, 0-1. Takes the float's exact value, so call when it changes rather than every pass.
+    void setFadeCurve(float fadeCurve)
+    {
+        uint32_t bits;
+        memcpy(&bits, &fadeCurve, sizeof(bits));
+
+        int exponent = (bits >> 23) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        // Curves too slight to have a float exponent we can shift by are no curve, the menu treats anything under 0.001 as blend anyway
+        if (exponent == 0 || (bits & 0x80000000) || exponent - 150 < -40)
+        {
+            curveOne.mantissa = 1;
+            curveOne.exponent = 0;
+        }
+        else
+        {
+            // 1.0 + fadeCurve in double is exact
+            curveOne.exponent = exponent - 150;
+            curveOne.mantissa = (uint64_t(1) << -curveOne.exponent) + (mantissa | 0x800000);
+        }
+
+        // 1 + fadeCurve in float is not
+        curveOneFloat = curveOne;
+        roundToFloat(curveOneFloat);
+    }
+
+    // Window A occludes B, so B has to be factored by what A is letting through
+    void blend(int32_t xFade, int32_t fadeUp, int32_t &fadeA, int32_t &fadeB)
+    {
+        if (xFade > 0)
+        {
+            fadeA = percentOfProduct(kSPKMixEngineOne - xFade, fadeUp);
+
+            // xFade*fadeUp is a float product
+            valueType numerator = { uint64_t(xFade) * fadeUp, -32 };
+            roundToFloat(numerator);
+
+            // 1 - fadeUp + numerator is exact in double, so bring both to the finer exponent
+            int exponent = (numerator.exponent < -16) ? numerator.exponent : -16;
+            uint64_t n = numerator.mantissa << (numerator.exponent - exponent);
+            uint64_t d = (uint64_t(kSPKMixEngineOne - fadeUp) << (-16 - exponent)) + n;
+
+            uint64_t scaled = (n * 100) << 16;
+            uint64_t quotient = scaled / d;
+            fadeB = int32_t(quotient);
+
+            // The division and *100 each round in double, and a whole-percent quotient can land just under.
+            // A quotient of exactly W/100 divides to the same double as the literal 0.W would, and of 0.00 to 1.00
+            // only 0.29, 0.57 and 0.58 come back from *100 below the whole number, ie. 0.29 * 100.0 is 28.999999999999996.
+            // Exact is checked by multiplying back, as a second 64-bit division would be another __aeabi_uldivmod call.
+            if ((quotient & 0xFFFF) == 0 && quotient * d == scaled)
+            {
+                uint32_t whole = uint32_t(quotient >> 16);
+                if (whole == 29 || whole == 57 || whole == 58) fadeB -= 1;
+            }
+        }
+        else
+        {
+            fadeA = percent(fadeUp);
+            fadeB = 0;
+        }
+    }
+
+    // Both windows fade in towards the middle of the crossfade, by how much set by the fade curve
+    void additive(int32_t xFade, int32_t fadeUp, int32_t &fadeA, int32_t &fadeB)
+    {
+        // (1.0-xFade) * (1.0 + fadeCurve) is exact in double, then stored to float
+        valueType a = { uint64_t(kSPKMixEngineOne - xFade) * curveOne.mantissa, curveOne.exponent - 16 };
+        roundToFloat(a);
+
+        // xFade * (1 + fadeCurve) is a float product
+        valueType b = { uint64_t(xFade) * curveOneFloat.mantissa, curveOneFloat.exponent - 16 };
+        roundToFloat(b);
+
+        fadeA = percentOfFloat(a, fadeUp);
+        fadeB = percentOfFloat(b, fadeUp);
+    }
+
+    void keyLeft(int32_t xFade, int32_t fadeUp, int32_t &fadeA, int32_t &fadeB)
+    {
+        fadeA = percentOfProduct(kSPKMixEngineOne - xFade, fadeUp);
+        fadeB = percent(fadeUp);
+    }
+
+    void keyRight(int32_t xFade, int32_t fadeUp, int32_t &fadeA, int32_t &fadeB)
+    {
+        fadeA = percent(fadeUp);
+
+        // xFade * fadeUp is a float product
+        valueType b = { uint64_t(xFade) * fadeUp, -32 };
+        roundToFloat(b);
+        fadeB = percentOf(b);
+    }
+
+private:
+    // mantissa * 2^exponent
+    struct valueType { uint64_t mantissa; int exponent; };
+
+    // To the nearest float, ties to even, as the FPU or soft-float library would
+    static void roundToFloat(valueType &value)
+    {
+        if (value.mantissa < (uint64_t(1) << 24)) return;
+
+        // CLZ on the Cortex-M3, rather than a loop over the bits
+        int bits = 64 - __builtin_clzll(value.mantissa);
+
+        int shift = bits - 24;
+        uint64_t kept = value.mantissa >> shift;
+        uint64_t remainder = value.mantissa & ((uint64_t(1) << shift) - 1);
+        uint64_t half = uint64_t(1) << (shift - 1);
+
+        if (remainder > half || (remainder == half && (kept & 1))) kept++;
+
+        value.mantissa = kept;
+        value.exponent += shift;
+    }
+
+    // 16.16 percent of a value, truncated
+    static int32_t percentOf(const valueType &value)
+    {
+        uint64_t scaled = value.mantissa * 100;
+        int shift = value.exponent + 16;
+        return int32_t(shift >= 0 ? scaled << shift : scaled >> -shift);
+    }
+
+    // A float clamped to 1, times fadeUp as a float product, then as percent
+    static int32_t percentOfFloat(valueType value, int32_t fadeUp)
+    {
+        if (value.exponent >= 0 || value.mantissa > (uint64_t(1) << -value.exponent))
+        {
+            value.mantissa = 1;
+            value.exponent = 0;
+        }
+
+        value.mantissa *= fadeUp;
+        value.exponent -= 16;
+        roundToFloat(value);
+
+        return percentOf(value);
+    }
+
+    // Products of two positions are exact in double
+    static int32_t percentOfProduct(int32_t x, int32_t y)
+    {
+        return int32_t((uint64_t(x) * uint32_t(y) * 100) >> 16);
+    }
+
+    static int32_t percent(int32_t x)
+    {
+        return x * 100;
+    }
+
+    valueType curveOne;
+    valueType curveOneFloat;
+};
+
+#endif
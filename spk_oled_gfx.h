@@ -31,104 +31,117 @@ const uint8_t spkDisplayAllPixelsOn[] = {
 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
 };
 
-// number of columns, column0 hex, column1 hex...
-const uint8_t char33[] = {1, 0x2F};
-const uint8_t char34[] = {1, 0x06};
-const uint8_t char35[] = {5, 0x14, 0x3E, 0x14, 0x3E, 0x14};
-const uint8_t char36[] = {5, 0x24, 0x2A, 0x7F, 0x2A, 0x12};
-const uint8_t char37[] = {5, 0x06, 0x36, 0x08, 0x36, 0x30};
-const uint8_t char38[] = {6, 0x14, 0x2A, 0x2A, 0x24, 0x10, 0x08};
-const uint8_t char39[] = {1, 0x06};
-const uint8_t char40[] = {2, 0x3E, 0x41};
-const uint8_t char41[] = {2, 0x41, 0x3E};
-const uint8_t char42[] = {5, 0x14, 0x08, 0x3E, 0x08, 0x14};
-const uint8_t char43[] = {5, 0x08, 0x08, 0x3E, 0x08, 0x08};
-const uint8_t char44[] = {2, 0x40, 0x20};
-const uint8_t char45[] = {3, 0x08, 0x08, 0x08};
-const uint8_t char46[] = {1, 0x20};
-const uint8_t char47[] = {3, 0x30, 0x08, 0x06};
-const uint8_t char48[] = {5, 0x1C, 0x22, 0x2A, 0x22, 0x1C};
-const uint8_t char49[] = {3, 0x22, 0x3E, 0x20};
-const uint8_t char50[] = {5, 0x32, 0x2A, 0x2A, 0x2A, 0x24};
-const uint8_t char51[] = {5, 0x22, 0x2A, 0x2A, 0x2A, 0x14};
-const uint8_t char52[] = {5, 0x18, 0x14, 0x12, 0x3E, 0x10};
-const uint8_t char53[] = {5, 0x2E, 0x2A, 0x2A, 0x2A, 0x12};
-const uint8_t char54[] = {5, 0x1C, 0x2A, 0x2A, 0x2A, 0x10};
-const uint8_t char55[] = {4, 0x02, 0x32, 0x0A, 0x06};
-const uint8_t char56[] = {5, 0x14, 0x2A, 0x2A, 0x2A, 0x14};
-const uint8_t char57[] = {5, 0x04, 0x2A, 0x2A, 0x2A, 0x1C};
-const uint8_t char58[] = {1, 0x24};
-const uint8_t char59[] = {2, 0x40, 0x24};
-const uint8_t char60[] = {3, 0x08, 0x14, 0x22};
-const uint8_t char61[] = {4, 0x14, 0x14, 0x14, 0x14};
-const uint8_t char62[] = {3, 0x22, 0x14, 0x08};
-const uint8_t char63[] = {4, 0x01, 0x2D, 0x05, 0x02};
-const uint8_t char64[] = {6, 0x3E, 0x41, 0x4D, 0x55, 0x15, 0x1E};
-const uint8_t char65[] = {5, 0x3C, 0x0A, 0x0A, 0x0A, 0x3C};
-const uint8_t char66[] = {5, 0x3E, 0x2A, 0x2A, 0x2A, 0x14};
-const uint8_t char67[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x14};
-const uint8_t char68[] = {5, 0x3E, 0x22, 0x22, 0x22, 0x1C};
-const uint8_t char69[] = {4, 0x3E, 0x2A, 0x2A, 0x22};
-const uint8_t char70[] = {4, 0x3E, 0x0A, 0x0A, 0x02};
-const uint8_t char71[] = {5, 0x1C, 0x22, 0x22, 0x2A, 0x1A};
-const uint8_t char72[] = {5, 0x3E, 0x08, 0x08, 0x08, 0x3E};
-const uint8_t char73[] = {1, 0x3E};
-const uint8_t char74[] = {5, 0x10, 0x20, 0x20, 0x20, 0x1E};
-const uint8_t char75[] = {5, 0x3E, 0x08, 0x08, 0x14, 0x22};
-const uint8_t char76[] = {4, 0x3E, 0x20, 0x20, 0x20};
-const uint8_t char77[] = {5, 0x3E, 0x04, 0x08, 0x04, 0x3E};
-const uint8_t char78[] = {5, 0x3E, 0x04, 0x08, 0x10, 0x3E};
-const uint8_t char79[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x1C};
-const uint8_t char80[] = {5, 0x3E, 0x0A, 0x0A, 0x0A, 0x04};
-const uint8_t char81[] = {5, 0x1C, 0x22, 0x72, 0xA2, 0x1C};
-const uint8_t char82[] = {5, 0x3E, 0x0A, 0x0A, 0x1A, 0x24};
-const uint8_t char83[] = {5, 0x24, 0x2A, 0x2A, 0x2A, 0x12};
-const uint8_t char84[] = {5, 0x02, 0x02, 0x3E, 0x02, 0x02};
-const uint8_t char85[] = {5, 0x1E, 0x20, 0x20, 0x20, 0x1E};
-const uint8_t char86[] = {5, 0x06, 0x18, 0x20, 0x18, 0x06};
-const uint8_t char87[] = {7, 0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E};
-const uint8_t char88[] = {5, 0x22, 0x14, 0x08, 0x14, 0x22};
-const uint8_t char89[] = {5, 0x02, 0x04, 0x38, 0x04, 0x02};
-const uint8_t char90[] = {5, 0x22, 0x32, 0x2A, 0x26, 0x22};
-const uint8_t char91[] = {2, 0x7F, 0x41};
-const uint8_t char92[] = {3, 0x06, 0x08, 0x30};
-const uint8_t char93[] = {2, 0x41, 0x7F};
-const uint8_t char94[] = {3, 0x04, 0x02, 0x04};
-const uint8_t char95[] = {4, 0x40, 0x40, 0x40, 0x40};
-const uint8_t char96[] = {2, 0x02, 0x04};
-const uint8_t char97[] = {5, 0x3C, 0x0A, 0x0A, 0x0A, 0x3C};
-const uint8_t char98[] = {5, 0x3E, 0x2A, 0x2A, 0x2A, 0x14};
-const uint8_t char99[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x14};
-const uint8_t char100[] = {5, 0x3E, 0x22, 0x22, 0x22, 0x1C};
-const uint8_t char101[] = {4, 0x1C, 0x2A, 0x2A, 0x22};
-const uint8_t char102[] = {4, 0x3E, 0x0A, 0x0A, 0x02};
-const uint8_t char103[] = {5, 0x1C, 0xA2, 0xA2, 0xAA, 0x7A};
-const uint8_t char104[] = {5, 0x3E, 0x08, 0x08, 0x08, 0x3E};
-const uint8_t char105[] = {1, 0x3A};
-const uint8_t char106[] = {5, 0x10, 0x20, 0x22, 0x22, 0x1E};
-const uint8_t char107[] = {5, 0x3E, 0x08, 0x08, 0x14, 0x22};
-const uint8_t char108[] = {4, 0x3E, 0x20, 0x20, 0x20};
-const uint8_t char109[] = {5, 0x3E, 0x04, 0x08, 0x04, 0x3E};
-const uint8_t char110[] = {5, 0x3E, 0x04, 0x08, 0x10, 0x3E};
-const uint8_t char111[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x1C};
-const uint8_t char112[] = {5, 0x3E, 0x0A, 0x0A, 0x0A, 0x04};
-const uint8_t char113[] = {5, 0x1C, 0x22, 0x72, 0xA2, 0x1C};
-const uint8_t char114[] = {5, 0x3E, 0x0A, 0x0A, 0x1A, 0x24};
-const uint8_t char115[] = {5, 0x24, 0x2A, 0x2A, 0x2A, 0x12};
-const uint8_t char116[] = {5, 0x02, 0x02, 0x3E, 0x02, 0x02};
-const uint8_t char117[] = {5, 0x1E, 0x20, 0x20, 0x20, 0x1E};
-const uint8_t char118[] = {5, 0x06, 0x18, 0x20, 0x18, 0x06};
-const uint8_t char119[] = {7, 0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E};
-const uint8_t char120[] = {5, 0x22, 0x14, 0x08, 0x14, 0x22};
-const uint8_t char121[] = {5, 0x02, 0x04, 0x38, 0x04, 0x02};
-const uint8_t char122[] = {5, 0x22, 0x32, 0x2A, 0x26, 0x22};
-const uint8_t char123[] = {3, 0x08, 0x77, 0x41};
-const uint8_t char124[] = {1, 0x3E};
-const uint8_t char125[] = {3, 0x41, 0x77, 0x08};
-const uint8_t char126[] = {4, 0x04, 0x02, 0x04, 0x02};
+// Packed font: every character's columns end to end, from fontStartChar to fontEndChar.
+// A character's columns start at its offset, and run to the next character's.
+// Generated from the glyphs as they were drawn one array per character, so it's a table rather than code.
 
-const int characterBytesStartChar = 33;
-const int characterBytesEndChar = 126;
-const uint8_t* characterBytes[] = {char33, char34, char35, char36, char37, char38, char39, char40, char41, char42, char43, char44, char45, char46, char47, char48, char49, char50, char51, char52, char53, char54, char55, char56, char57, char58, char59, char60, char61, char62, char63, char64, char65, char66, char67, char68, char69, char70, char71, char72, char73, char74, char75, char76, char77, char78, char79, char80, char81, char82, char83, char84, char85, char86, char87, char88, char89, char90, char91, char92, char93, char94, char95, char96, char97, char98, char99, char100, char101, char102, char103, char104, char105, char106, char107, char108, char109, char110, char111, char112, char113, char114, char115, char116, char117, char118, char119, char120, char121, char122, char123, char124, char125, char126, };
+const int fontStartChar = 33;
+const int fontEndChar = 126;
+
+const uint8_t fontColumns[] = {
+    0x2F,                                    // 33 !
+    0x06,                                    // 34 "
+    0x14, 0x3E, 0x14, 0x3E, 0x14,            // 35 #
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,            // 36 $
+    0x06, 0x36, 0x08, 0x36, 0x30,            // 37 %
+    0x14, 0x2A, 0x2A, 0x24, 0x10, 0x08,      // 38 &
+    0x06,                                    // 39 '
+    0x3E, 0x41,                              // 40 (
+    0x41, 0x3E,                              // 41 )
+    0x14, 0x08, 0x3E, 0x08, 0x14,            // 42 *
+    0x08, 0x08, 0x3E, 0x08, 0x08,            // 43 +
+    0x40, 0x20,                              // 44 ,
+    0x08, 0x08, 0x08,                        // 45 -
+    0x20,                                    // 46 .
+    0x30, 0x08, 0x06,                        // 47 /
+    0x1C, 0x22, 0x2A, 0x22, 0x1C,            // 48 0
+    0x22, 0x3E, 0x20,                        // 49 1
+    0x32, 0x2A, 0x2A, 0x2A, 0x24,            // 50 2
+    0x22, 0x2A, 0x2A, 0x2A, 0x14,            // 51 3
+    0x18, 0x14, 0x12, 0x3E, 0x10,            // 52 4
+    0x2E, 0x2A, 0x2A, 0x2A, 0x12,            // 53 5
+    0x1C, 0x2A, 0x2A, 0x2A, 0x10,            // 54 6
+    0x02, 0x32, 0x0A, 0x06,                  // 55 7
+    0x14, 0x2A, 0x2A, 0x2A, 0x14,            // 56 8
+    0x04, 0x2A, 0x2A, 0x2A, 0x1C,            // 57 9
+    0x24,                                    // 58 :
+    0x40, 0x24,                              // 59 ;
+    0x08, 0x14, 0x22,                        // 60 <
+    0x14, 0x14, 0x14, 0x14,                  // 61 =
+    0x22, 0x14, 0x08,                        // 62 >
+    0x01, 0x2D, 0x05, 0x02,                  // 63 ?
+    0x3E, 0x41, 0x4D, 0x55, 0x15, 0x1E,      // 64 @
+    0x3C, 0x0A, 0x0A, 0x0A, 0x3C,            // 65 A
+    0x3E, 0x2A, 0x2A, 0x2A, 0x14,            // 66 B
+    0x1C, 0x22, 0x22, 0x22, 0x14,            // 67 C
+    0x3E, 0x22, 0x22, 0x22, 0x1C,            // 68 D
+    0x3E, 0x2A, 0x2A, 0x22,                  // 69 E
+    0x3E, 0x0A, 0x0A, 0x02,                  // 70 F
+    0x1C, 0x22, 0x22, 0x2A, 0x1A,            // 71 G
+    0x3E, 0x08, 0x08, 0x08, 0x3E,            // 72 H
+    0x3E,                                    // 73 I
+    0x10, 0x20, 0x20, 0x20, 0x1E,            // 74 J
+    0x3E, 0x08, 0x08, 0x14, 0x22,            // 75 K
+    0x3E, 0x20, 0x20, 0x20,                  // 76 L
+    0x3E, 0x04, 0x08, 0x04, 0x3E,            // 77 M
+    0x3E, 0x04, 0x08, 0x10, 0x3E,            // 78 N
+    0x1C, 0x22, 0x22, 0x22, 0x1C,            // 79 O
+    0x3E, 0x0A, 0x0A, 0x0A, 0x04,            // 80 P
+    0x1C, 0x22, 0x72, 0xA2, 0x1C,            // 81 Q
+    0x3E, 0x0A, 0x0A, 0x1A, 0x24,            // 82 R
+    0x24, 0x2A, 0x2A, 0x2A, 0x12,            // 83 S
+    0x02, 0x02, 0x3E, 0x02, 0x02,            // 84 T
+    0x1E, 0x20, 0x20, 0x20, 0x1E,            // 85 U
+    0x06, 0x18, 0x20, 0x18, 0x06,            // 86 V
+    0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E, // 87 W
+    0x22, 0x14, 0x08, 0x14, 0x22,            // 88 X
+    0x02, 0x04, 0x38, 0x04, 0x02,            // 89 Y
+    0x22, 0x32, 0x2A, 0x26, 0x22,            // 90 Z
+    0x7F, 0x41,                              // 91 [
+    0x06, 0x08, 0x30,                        // 92 backslash
+    0x41, 0x7F,                              // 93 ]
+    0x04, 0x02, 0x04,                        // 94 ^
+    0x40, 0x40, 0x40, 0x40,                  // 95 _
+    0x02, 0x04,                              // 96 `
+    0x3C, 0x0A, 0x0A, 0x0A, 0x3C,            // 97 a
+    0x3E, 0x2A, 0x2A, 0x2A, 0x14,            // 98 b
+    0x1C, 0x22, 0x22, 0x22, 0x14,            // 99 c
+    0x3E, 0x22, 0x22, 0x22, 0x1C,            // 100 d
+    0x1C, 0x2A, 0x2A, 0x22,                  // 101 e
+    0x3E, 0x0A, 0x0A, 0x02,                  // 102 f
+    0x1C, 0xA2, 0xA2, 0xAA, 0x7A,            // 103 g
+    0x3E, 0x08, 0x08, 0x08, 0x3E,            // 104 h
+    0x3A,                                    // 105 i
+    0x10, 0x20, 0x22, 0x22, 0x1E,            // 106 j
+    0x3E, 0x08, 0x08, 0x14, 0x22,            // 107 k
+    0x3E, 0x20, 0x20, 0x20,                  // 108 l
+    0x3E, 0x04, 0x08, 0x04, 0x3E,            // 109 m
+    0x3E, 0x04, 0x08, 0x10, 0x3E,            // 110 n
+    0x1C, 0x22, 0x22, 0x22, 0x1C,            // 111 o
+    0x3E, 0x0A, 0x0A, 0x0A, 0x04,            // 112 p
+    0x1C, 0x22, 0x72, 0xA2, 0x1C,            // 113 q
+    0x3E, 0x0A, 0x0A, 0x1A, 0x24,            // 114 r
+    0x24, 0x2A, 0x2A, 0x2A, 0x12,            // 115 s
+    0x02, 0x02, 0x3E, 0x02, 0x02,            // 116 t
+    0x1E, 0x20, 0x20, 0x20, 0x1E,            // 117 u
+    0x06, 0x18, 0x20, 0x18, 0x06,            // 118 v
+    0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E, // 119 w
+    0x22, 0x14, 0x08, 0x14, 0x22,            // 120 x
+    0x02, 0x04, 0x38, 0x04, 0x02,            // 121 y
+    0x22, 0x32, 0x2A, 0x26, 0x22,            // 122 z
+    0x08, 0x77, 0x41,                        // 123 {
+    0x3E,                                    // 124 |
+    0x41, 0x77, 0x08,                        // 125 }
+    0x04, 0x02, 0x04, 0x02,                  // 126 ~
+};
+
+const uint16_t fontOffsets[] = {
+    0, 1, 2, 7, 12, 17, 23, 24, 26, 28, 33, 38, 40, 43, 44, 47,
+    52, 55, 60, 65, 70, 75, 80, 84, 89, 94, 95, 97, 100, 104, 107, 111,
+    117, 122, 127, 132, 137, 141, 145, 150, 155, 156, 161, 166, 170, 175, 180, 185,
+    190, 195, 200, 205, 210, 215, 220, 227, 232, 237, 242, 244, 247, 249, 252, 256,
+    258, 263, 268, 273, 278, 282, 286, 291, 296, 297, 302, 307, 311, 316, 321, 326,
+    331, 336, 341, 346, 351, 356, 361, 368, 373, 378, 383, 386, 387, 390, 394,
+};
 
 #endif
\ No newline at end of file
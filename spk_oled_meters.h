@@ -0,0 +1,179 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_OLED_METERS draws live levels and link health in the top rows of the SPKDisplay, where the splash screen is otherwise left.
+// Rows 0 and 1 are bar meters of the A and B window fade percents, as sent to the processor.
+// Row 2 is two scrolling sparklines from the TVOne link pacing, smoothed round-trip time on the left and the failed command rate on the right.
+// Each is a column per sample, growing up from the bottom of the row. The RTT column adds any backoff, so it rises with a failure and falls back as the backoff relaxes.
+// Only the columns that differ from what was last drawn are written, so a steady level or graph costs nothing to redraw.
+
+#ifndef SPK_OLED_METERS_h
+#define SPK_OLED_METERS_h
+
+#include "mbed.h"
+
+#define kSPKMetersRowA              0
+#define kSPKMetersRowB              1
+#define kSPKMetersRowLink           2
+#define kSPKMetersBarStart          8   // After the A and B labels
+#define kSPKMetersBarWidth          (pixWidth - kSPKMetersBarStart)
+#define kSPKMetersGraphWidth        62
+#define kSPKMetersErrorGraphStart   (pixWidth - kSPKMetersGraphWidth)
+#define kSPKMetersGraphHeight       7   // The bottom pixel of the row is left for the line the menu draws under it
+#define kSPKMetersSampleMillis      250 // So the graphs show the last 15 seconds or so
+#define kSPKMetersRTTFullMillis     100
+
+class SPKDisplayMeters {
+public:
+    SPKDisplayMeters(SPKDisplay *display, SPKTVOnePacing *linkPacing)
+    {
+        screen = display;
+        pacing = linkPacing;
+        active = false;
+    }
+
+    // Clears the rows and draws from scratch
+    void start()
+    {
+        uint8_t blank[pixWidth];
+        memset(blank, 0, pixWidth);
+        screen->clearBufferRow(kSPKMetersRowA);
+        screen->clearBufferRow(kSPKMetersRowB);
+        screen->bitmapToBuffer(blank, 0, pixWidth, kSPKMetersRowLink, (1 << kSPKMetersGraphHeight) - 1);
+        screen->characterToBuffer('A', 0, kSPKMetersRowA);
+        screen->characterToBuffer('B', 0, kSPKMetersRowB);
+
+        drawnA = drawnB = -1;
+        memset(rttHistory, 0, sizeof(rttHistory));
+        memset(errorHistory, 0, sizeof(errorHistory));
+        memset(drawnRTT, 0xFF, sizeof(drawnRTT));
+        memset(drawnError, 0xFF, sizeof(drawnError));
+
+        lastSampleMillis = clock.millis();
+        lastSamplesTaken = pacing->samplesTaken();
+        lastSamplesFailed = pacing->samplesFailed();
+
+        active = true;
+        drawGraph(rttHistory, drawnRTT, 0);
+        drawGraph(errorHistory, drawnError, kSPKMetersErrorGraphStart);
+    }
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() { return active; }
+
+    // Call every pass of the main loop, before the frame is presented
+    void update(int fadeAPercent, int fadeBPercent)
+    {
+        if (!active) return;
+
+        drawMeter(kSPKMetersRowA, fadeAPercent, drawnA);
+        drawMeter(kSPKMetersRowB, fadeBPercent, drawnB);
+
+        uint32_t now = clock.millis();
+        if (now - lastSampleMillis >= kSPKMetersSampleMillis)
+        {
+            lastSampleMillis = now;
+            sampleLink();
+            drawGraph(rttHistory, drawnRTT, 0);
+            drawGraph(errorHistory, drawnError, kSPKMetersErrorGraphStart);
+        }
+    }
+
+private:
+    // Redraws only the columns between the old and new bar ends
+    void drawMeter(int row, int percent, int &drawnLength)
+    {
+        if (percent < 0) percent = 0;
+        if (percent > 100) percent = 100;
+        int length = percent * kSPKMetersBarWidth / 100;
+
+        int start = 0, end = kSPKMetersBarWidth;
+        if (drawnLength >= 0)
+        {
+            if (length == drawnLength) return;
+            start = (length < drawnLength) ? length : drawnLength;
+            end = (length < drawnLength) ? drawnLength : length;
+        }
+
+        // Filled, or a baseline to show the scale
+        uint8_t columns[kSPKMetersBarWidth];
+        for (int x=start; x < end; x++) columns[x] = (x < length) ? 0x3E : 0x20;
+
+        screen->bitmapToBuffer(columns + start, kSPKMetersBarStart + start, end - start, row);
+        drawnLength = length;
+    }
+
+    void sampleLink()
+    {
+        uint32_t taken = pacing->samplesTaken();
+        uint32_t failed = pacing->samplesFailed();
+        uint32_t takenSince = taken - lastSamplesTaken;
+        uint32_t failedSince = failed - lastSamplesFailed;
+        lastSamplesTaken = taken;
+        lastSamplesFailed = failed;
+
+        // What a command is costing, ie. the round trip and the backoff the pacing adds to the period
+        int rttMillis = pacing->smoothedRTTMillis() + pacing->currentBackoffMillis();
+        int rttHeight = (rttMillis * kSPKMetersGraphHeight + kSPKMetersRTTFullMillis - 1) / kSPKMetersRTTFullMillis;
+        if (rttHeight > kSPKMetersGraphHeight) rttHeight = kSPKMetersGraphHeight;
+
+        // Any failure shows, so round up
+        int errorHeight = 0;
+        if (takenSince > 0) errorHeight = (failedSince * kSPKMetersGraphHeight + takenSince - 1) / takenSince;
+
+        memmove(rttHistory, rttHistory + 1, kSPKMetersGraphWidth - 1);
+        memmove(errorHistory, errorHistory + 1, kSPKMetersGraphWidth - 1);
+        rttHistory[kSPKMetersGraphWidth - 1] = rttHeight;
+        errorHistory[kSPKMetersGraphWidth - 1] = errorHeight;
+    }
+
+    // Writes the span of columns that changed since last drawn
+    void drawGraph(const uint8_t *history, uint8_t *drawn, int x)
+    {
+        uint8_t columns[kSPKMetersGraphWidth];
+        int first = kSPKMetersGraphWidth, last = -1;
+
+        for (int i=0; i < kSPKMetersGraphWidth; i++)
+        {
+            // Rows grow down from bit 0, so a bar up from bit 6
+            int height = history[i];
+            columns[i] = ((1 << height) - 1) << (kSPKMetersGraphHeight - height);
+
+            if (columns[i] != drawn[i])
+            {
+                if (i < first) first = i;
+                last = i;
+                drawn[i] = columns[i];
+            }
+        }
+
+        if (last < 0) return;
+
+        uint8_t mask = (1 << kSPKMetersGraphHeight) - 1;
+        screen->bitmapToBuffer(columns + first, x + first, last - first + 1, kSPKMetersRowLink, mask);
+    }
+
+    SPKDisplay *screen;
+    SPKTVOnePacing *pacing;
+    SPKClock clock;
+    bool active;
+
+    int drawnA;
+    int drawnB;
+
+    uint8_t rttHistory[kSPKMetersGraphWidth];
+    uint8_t errorHistory[kSPKMetersGraphWidth];
+    uint8_t drawnRTT[kSPKMetersGraphWidth];
+    uint8_t drawnError[kSPKMetersGraphWidth];
+
+    uint32_t lastSampleMillis;
+    uint32_t lastSamplesTaken;
+    uint32_t lastSamplesFailed;
+};
+
+#endif
@@ -0,0 +1,119 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_OLED_SCHEDULER puts text lines on the SPKDisplay at a capped frame rate, drawing only the latest text set for each.
+// Setting a line's text is a string assign, so network handlers can set the comms line on every packet.
+// update() from the main loop draws the lines and presents the frame, at most at the frame rate.
+// A line can be given an interval it is redrawn at most every, and such lines wait while the display is still sending the last frame.
+// So status text gives way to anything drawn directly, ie. the menu lines, which are presented every frame.
+
+#ifndef SPK_OLED_SCHEDULER_h
+#define SPK_OLED_SCHEDULER_h
+
+#include "mbed.h"
+#include <string>
+
+class SPKDisplayScheduler {
+public:
+    SPKDisplayScheduler(SPKDisplay *display, int frameRateHz = kSPKDisplayFrameRateHz)
+    {
+        screen = display;
+        setFrameRate(frameRateHz);
+        lastFrameMillis = clock.millis();
+
+        for (int row=0; row < pixPages; row++)
+        {
+            lines[row].intervalMillis = 0;
+            lines[row].drawnMillis = lastFrameMillis;
+            lines[row].pending = false;
+        }
+    }
+
+    // Caps this and the display's frame Ticker
+    void setFrameRate(int frameRateHz)
+    {
+        if (frameRateHz < 1) frameRateHz = 1;
+        frameMillis = 1000 / frameRateHz;
+        screen->setFrameRate(frameRateHz);
+    }
+
+    // 0 to draw with every frame
+    void setInterval(int row, int intervalMillis)
+    {
+        if (row < 0 || row >= pixPages) return;
+        lines[row].intervalMillis = intervalMillis;
+    }
+
+    // Replaces the row with the text at the next frame that draws it
+    void setText(int row, std::string text)
+    {
+        if (row < 0 || row >= pixPages) return;
+
+        lines[row].text = text;
+        lines[row].pending = true;
+    }
+
+    // Call every pass of the main loop. Returns true if a frame was presented.
+    bool update()
+    {
+        uint32_t now = clock.millis();
+        if (now - lastFrameMillis < frameMillis) return false;
+
+        draw(now, false);
+        return true;
+    }
+
+    // Draws every line and presents now, eg. before work that will hold up the main loop
+    void flush()
+    {
+        draw(clock.millis(), true);
+    }
+
+private:
+    struct lineType {
+        std::string text;
+        std::string drawn;
+        int intervalMillis;
+        uint32_t drawnMillis;
+        bool pending;
+    };
+
+    void draw(uint32_t now, bool all)
+    {
+        bool screenBusy = screen->isSending();
+
+        for (int row=0; row < pixPages; row++)
+        {
+            lineType &line = lines[row];
+            if (!line.pending) continue;
+
+            if (!all && line.intervalMillis > 0)
+            {
+                if (screenBusy || now - line.drawnMillis < uint32_t(line.intervalMillis)) continue;
+            }
+
+            // Rewriting the same text would be compared away by the display, but this skips the render too
+            if (line.text != line.drawn)
+            {
+                screen->clearBufferRow(row);
+                screen->textToBuffer(line.text, row);
+                line.drawn = line.text;
+            }
+
+            line.pending = false;
+            line.drawnMillis = now;
+        }
+
+        screen->sendBuffer();
+        lastFrameMillis = now;
+    }
+
+    SPKDisplay *screen;
+    SPKClock clock;
+    lineType lines[pixPages];
+    uint32_t frameMillis;
+    uint32_t lastFrameMillis;
+};
+
+#endif
@@ -0,0 +1,544 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_OLED_SSD1305 drives the 128x64 OLED over SPI, drawing into a framebuffer that sendBuffer() pushes to the panel.
+// The framebuffer is 8 pages of 128 columns, a byte per column holding that page's 8 rows of pixels, LSB at the top.
+// It keeps a copy of what is on the panel, and the column range each page has been drawn into since the last frame.
+// So a frame compares just those ranges, and sends only the columns that actually changed, as a window per page.
+// Redrawing a row with the same text, as the main loop does every pass, then costs a compare rather than a frame of SPI.
+//
+// Sending doesn't hold up the caller. sendBuffer() presents what has been drawn, copying it to a ready frame, and returns.
+// A Ticker at the frame rate takes the ready frame if there is one, and GPDMA pushes its changes to the SSP from the panel copy.
+// The DMA interrupt sets up each page's window in turn, so between frames and windows there is nothing to wait on.
+// Drawing can carry on into the buffer meanwhile, as the frame being sent is never the one being drawn.
+// The DMA is set up for SSP1, ie. p5 and p7 as the D-Fuser wires the OLED, and takes over the DMA interrupt vector.
+//
+// Text is rendered a whole string at a time into a word-aligned line, then written to the row a word at a time.
+// labelToBuffer() keeps the rendered columns of the last few fixed strings, eg. menu titles, so showing one again is only the word copy.
+//
+// This driver replaces the spk_oled_ssd1305 library (mbed.org/users/tobyspark/code/spk_oled_ssd1305, revision 0d518115e76c), but is not derived from its source.
+// The SPI mode, column offset and setup values below are a generic SSD1305 128x64 setup, and have not been checked against that library or on a D-Fuser panel.
+// Until they have, the build warns. Check each against the library's setup() at that revision, or on a panel, then set kSPKDisplaySetupChecked.
+
+#ifndef SPK_OLED_SSD1305_h
+#define SPK_OLED_SSD1305_h
+
+#include "mbed.h"
+#include <string>
+
+#define pixWidth                128
+#define pixHeight               64
+#define pixInPage               8
+#define pixPages                (pixHeight / pixInPage)
+#define bufferCount             (pixWidth * pixPages)
+
+#define kSPKDisplaySetupChecked 0 // 1 once the values from here to kSPKDisplayVCOMH match the library or are seen right on a panel
+#define kSPKDisplayColumnOffset 0 // Where column 0 is in the controller's 132 column RAM
+#define kSPKDisplaySpaceWidth   2 // Space and anything not in the font
+#define kSPKDisplaySPIFrequency 1000000
+#define kSPKDisplaySPIMode      3
+#define kSPKDisplaySegmentRemap 0xA1 // Column 127 mapped to SEG0, 0xA0 for column 0
+#define kSPKDisplayCOMScan      0xC8 // Scan COM from the bottom, 0xC0 from the top
+#define kSPKDisplayCOMPins      0x12 // Alternative COM pin configuration
+#define kSPKDisplayClockDivide  0x10 // Oscillator frequency in the high nibble, divide ratio - 1 in the low
+#define kSPKDisplayContrast     0xBF
+#define kSPKDisplayPrecharge    0x22 // Phase 2 periods in the high nibble, phase 1 in the low
+#define kSPKDisplayVCOMH        0x34
+#define kSPKDisplayLabelCacheSize 8 // Each is a row of columns, 128 bytes
+#define kSPKDisplayFrameRateHz  30
+#define kSPKDisplaySSP          LPC_SSP1
+#define kSPKDisplayDMA          LPC_GPDMACH7 // The lowest priority channel
+#define kSPKDisplayDMAChannel   7
+#define kSPKDisplayDMARequest   2 // SSP1 Tx
+
+#if !kSPKDisplaySetupChecked
+#warning "SPKDisplay setup values not yet checked against spk_oled_ssd1305 revision 0d518115e76c or a D-Fuser panel"
+#endif
+
+class SPKDisplay {
+public:
+    SPKDisplay(PinName mosi, PinName clk, PinName cs, PinName dc, PinName res, Serial *debugSerial = NULL)
+        : spi(mosi, NC, clk), csOut(cs), dcOut(dc), resOut(res)
+    {
+        debug = debugSerial;
+
+        fontStartCharacter = NULL;
+        fontEndCharacter = NULL;
+        fontOffsets = NULL;
+        fontColumns = NULL;
+
+        for (int i=0; i < kSPKDisplayLabelCacheSize; i++)
+        {
+            labels[i].hash = 0;
+            labels[i].width = -1;
+            labels[i].lastUsed = 0;
+        }
+        labelUseCount = 0;
+
+        memset(buffer, 0, bufferCount);
+        memset(ready, 0, bufferCount);
+        memset(panel, 0, bufferCount);
+        for (int page=0; page < pixPages; page++)
+        {
+            markClean(dirtyStart, dirtyEnd, page);
+            markClean(readyStart, readyEnd, page);
+            markClean(windowStart, windowEnd, page);
+        }
+
+        frameMicros = 1000000 / kSPKDisplayFrameRateHz;
+        running = false;
+        sending = false;
+
+        setup();
+    }
+
+    // Set to the packed font in spk_oled_gfx.h, a character's columns running from its offset to the next's
+    const int *fontStartCharacter;
+    const int *fontEndCharacter;
+    const uint16_t *fontOffsets;
+    const uint8_t *fontColumns;
+
+    void clearBuffer()
+    {
+        memset(buffer, 0, bufferCount);
+        for (int page=0; page < pixPages; page++) markDirty(page, 0, pixWidth - 1);
+    }
+
+    void clearBufferRow(int row)
+    {
+        if (row < 0 || row >= pixPages) return;
+
+        memset(buffer + row*pixWidth, 0, pixWidth);
+        markDirty(row, 0, pixWidth - 1);
+    }
+
+    // A full screen image, as 8 pages of 128 columns
+    void imageToBuffer(const uint8_t* image)
+    {
+        memcpy(buffer, image, bufferCount);
+        for (int page=0; page < pixPages; page++) markDirty(page, 0, pixWidth - 1);
+    }
+
+    void horizLineToBuffer(int y)
+    {
+        if (y < 0 || y >= pixHeight) return;
+
+        int page = y / pixInPage;
+        uint8_t bit = 1 << (y % pixInPage);
+
+        uint8_t *column = buffer + page*pixWidth;
+        for (int x=0; x < pixWidth; x++) column[x] |= bit;
+
+        markDirty(page, 0, pixWidth - 1);
+    }
+
+    // Writes from the left of the row, over what is there. Clear the row first to lose a longer previous message.
+    void textToBuffer(std::string message, int row)
+    {
+        if (row < 0 || row >= pixPages) return;
+
+        int width = renderText(message, lineWords);
+        columnsToBuffer(lineWords, width, row);
+    }
+
+    // As textToBuffer(), for text that will be shown again as it is, eg. a menu title
+    void labelToBuffer(std::string message, int row)
+    {
+        if (row < 0 || row >= pixPages) return;
+
+        uint32_t hash = hashText(message);
+        labelType *label = &labels[0];
+        for (int i=0; i < kSPKDisplayLabelCacheSize; i++)
+        {
+            if (labels[i].width >= 0 && labels[i].hash == hash && labels[i].text == message)
+            {
+                label = &labels[i];
+                break;
+            }
+            if (labels[i].lastUsed < label->lastUsed) label = &labels[i];
+        }
+
+        // Not found, so take the least recently used
+        if (label->width < 0 || label->hash != hash || label->text != message)
+        {
+            label->text = message;
+            label->hash = hash;
+            label->width = renderText(message, label->columns);
+        }
+
+        label->lastUsed = ++labelUseCount;
+        columnsToBuffer(label->columns, label->width, row);
+    }
+
+    // Columns of pixels from x, eg. for graphics. Only the bits set in mask are written, so a line drawn across the row can be kept.
+    void bitmapToBuffer(const uint8_t *columns, int x, int width, int row, uint8_t mask = 0xFF)
+    {
+        if (row < 0 || row >= pixPages || x < 0 || x >= pixWidth || width <= 0) return;
+        if (x + width > pixWidth) width = pixWidth - x;
+
+        uint8_t *rowColumns = buffer + row*pixWidth + x;
+        for (int i=0; i < width; i++) rowColumns[i] = (rowColumns[i] & ~mask) | (columns[i] & mask);
+
+        markDirty(row, x, x + width - 1);
+    }
+
+    // Returns the columns the character took, including the gap after it
+    int characterToBuffer(char character, int x, int row)
+    {
+        if (row < 0 || row >= pixPages || x < 0 || x >= pixWidth) return 0;
+
+        int start, width;
+        if (!glyph(character, start, width)) return kSPKDisplaySpaceWidth + 1;
+
+        int drawn = (x + width > pixWidth) ? pixWidth - x : width;
+        memcpy(buffer + row*pixWidth + x, fontColumns + start, drawn);
+        markDirty(row, x, x + drawn - 1);
+
+        return width + 1;
+    }
+
+    // Presents what has been drawn, to be sent at the next frame. Returns once it's copied, which is at most a screen's worth of bytes.
+    void sendBuffer()
+    {
+        if (!running) start();
+
+        // The frame Ticker mustn't take a half-copied frame
+        __disable_irq();
+        for (int page=0; page < pixPages; page++)
+        {
+            if (dirtyStart[page] > dirtyEnd[page]) continue;
+
+            int offset = page*pixWidth + dirtyStart[page];
+            memcpy(ready + offset, buffer + offset, dirtyEnd[page] - dirtyStart[page] + 1);
+
+            if (dirtyStart[page] < readyStart[page]) readyStart[page] = dirtyStart[page];
+            if (dirtyEnd[page] > readyEnd[page]) readyEnd[page] = dirtyEnd[page];
+
+            markClean(dirtyStart, dirtyEnd, page);
+        }
+        __enable_irq();
+    }
+
+    // A frame is going out over DMA
+    bool isSending() { return sending; }
+
+    // How often a presented frame is taken to be sent
+    void setFrameRate(int frameRateHz)
+    {
+        if (frameRateHz < 1) frameRateHz = 1;
+        frameMicros = 1000000 / frameRateHz;
+
+        if (running) frameTicker.attach_us(this, &SPKDisplay::startFrame, frameMicros);
+    }
+
+private:
+    void start()
+    {
+        // Power up the GPDMA, and have the SSP request it when its transmit FIFO has room
+        LPC_SC->PCONP |= 1 << 29;
+        LPC_GPDMA->DMACConfig = 1;
+        kSPKDisplaySSP->DMACR = 1 << 1;
+
+        instance() = this;
+        NVIC_SetVector(DMA_IRQn, (uint32_t)(uintptr_t)&SPKDisplay::dmaInterrupt);
+        NVIC_EnableIRQ(DMA_IRQn);
+
+        frameTicker.attach_us(this, &SPKDisplay::startFrame, frameMicros);
+
+        running = true;
+    }
+
+    // Frame Ticker. Takes the ready frame's changes into the panel copy, and starts sending them.
+    void startFrame()
+    {
+        if (sending) return;
+
+        bool changed = false;
+        for (int page=0; page < pixPages; page++)
+        {
+            if (readyStart[page] > readyEnd[page]) continue;
+
+            const uint8_t *drawn = ready + page*pixWidth;
+            uint8_t *shown = panel + page*pixWidth;
+
+            // Narrow what was drawn to what differs
+            int start = readyStart[page];
+            int end = readyEnd[page];
+            while (start <= end && drawn[start] == shown[start]) start++;
+            while (end >= start && drawn[end] == shown[end]) end--;
+
+            if (start <= end)
+            {
+                memcpy(shown + start, drawn + start, end - start + 1);
+                windowStart[page] = start;
+                windowEnd[page] = end;
+                changed = true;
+            }
+
+            markClean(readyStart, readyEnd, page);
+        }
+
+        if (!changed) return;
+
+        sending = true;
+        windowPage = -1;
+        nextWindow();
+    }
+
+    // Sends the next page's window address, then starts the DMA of its columns
+    void nextWindow()
+    {
+        do windowPage++;
+        while (windowPage < pixPages && windowStart[windowPage] > windowEnd[windowPage]);
+
+        if (windowPage == pixPages)
+        {
+            sending = false;
+            return;
+        }
+
+        int start = windowStart[windowPage];
+        int end = windowEnd[windowPage];
+        int column = start + kSPKDisplayColumnOffset;
+        markClean(windowStart, windowEnd, windowPage);
+
+        dcOut = 0;
+        csOut = 0;
+        kSPKDisplaySSP->DR = 0xB0 | windowPage;
+        kSPKDisplaySSP->DR = 0x00 | (column & 0x0F);
+        kSPKDisplaySSP->DR = 0x10 | (column >> 4);
+        waitForSSP();
+        dcOut = 1;
+
+        LPC_GPDMA->DMACIntTCClear = 1 << kSPKDisplayDMAChannel;
+        LPC_GPDMA->DMACIntErrClr = 1 << kSPKDisplayDMAChannel;
+
+        kSPKDisplayDMA->DMACCSrcAddr = (uint32_t)(uintptr_t)(panel + windowPage*pixWidth + start);
+        kSPKDisplayDMA->DMACCDestAddr = (uint32_t)(uintptr_t)&kSPKDisplaySSP->DR;
+        kSPKDisplayDMA->DMACCLLI = 0;
+        kSPKDisplayDMA->DMACCControl = (end - start + 1)    // Transfer size, in bursts of one byte
+                                     | (1 << 26)            // Source increment
+                                     | (1u << 31);          // Terminal count interrupt
+        kSPKDisplayDMA->DMACCConfig = 1                     // Enable
+                                    | (kSPKDisplayDMARequest << 6)
+                                    | (1 << 11)             // Memory to peripheral
+                                    | (1 << 14)             // Error interrupt
+                                    | (1 << 15);            // Terminal count interrupt
+    }
+
+    void onDMA()
+    {
+        uint32_t channel = 1 << kSPKDisplayDMAChannel;
+        if (!((LPC_GPDMA->DMACIntTCStat | LPC_GPDMA->DMACIntErrStat) & channel)) return;
+
+        LPC_GPDMA->DMACIntTCClear = channel;
+        LPC_GPDMA->DMACIntErrClr = channel;
+
+        // The DMA is done when the last byte is in the FIFO, not out of it
+        waitForSSP();
+        csOut = 1;
+
+        nextWindow();
+    }
+
+    // Until sent, discarding what was clocked in as there's no MISO
+    void waitForSSP()
+    {
+        while (kSPKDisplaySSP->SR & (1 << 4));
+        while (kSPKDisplaySSP->SR & (1 << 2))
+        {
+            uint32_t discard = kSPKDisplaySSP->DR;
+            (void)discard;
+        }
+    }
+
+    static SPKDisplay*& instance()
+    {
+        static SPKDisplay *display = NULL;
+        return display;
+    }
+
+    static void dmaInterrupt()
+    {
+        if (instance()) instance()->onDMA();
+    }
+
+    void setup()
+    {
+        spi.format(8, kSPKDisplaySPIMode);
+        spi.frequency(kSPKDisplaySPIFrequency);
+
+        csOut = 1;
+        resOut = 0;
+        wait_ms(1);
+        resOut = 1;
+        wait_ms(1);
+
+        const uint8_t commands[] = {
+            0xAE,                           // Display off
+            0xD5, kSPKDisplayClockDivide,   // Clock divide and oscillator frequency
+            0xA8, 0x3F,                     // Multiplex ratio, 64 rows
+            0xD3, 0x00,                     // Display offset
+            0x40,                           // Start line 0
+            0x20, 0x02,                     // Page addressing, so a window is a page and a start column
+            kSPKDisplaySegmentRemap,        // Column to segment mapping
+            kSPKDisplayCOMScan,             // COM scan direction
+            0xDA, kSPKDisplayCOMPins,       // COM pins configuration
+            0x81, kSPKDisplayContrast,      // Contrast
+            0xD9, kSPKDisplayPrecharge,     // Pre-charge period
+            0xDB, kSPKDisplayVCOMH,         // VCOMH deselect level
+            0xA4,                           // Display from RAM
+            0xA6,                           // Not inverted
+        };
+        sendCommands(commands, sizeof(commands));
+
+        // The panel's RAM is random after reset, so make it match our copy
+        for (int page=0; page < pixPages; page++)
+        {
+            const uint8_t address[] = { uint8_t(0xB0 | page), uint8_t(kSPKDisplayColumnOffset & 0x0F), uint8_t(0x10 | (kSPKDisplayColumnOffset >> 4)) };
+            sendCommands(address, sizeof(address));
+
+            dcOut = 1;
+            csOut = 0;
+            for (int x=0; x < pixWidth; x++) spi.write(0);
+            csOut = 1;
+        }
+
+        const uint8_t displayOn = 0xAF;
+        sendCommands(&displayOn, 1);
+
+        if (debug) debug->printf("SPKDisplay: Setup%s\r\n", kSPKDisplaySetupChecked ? "" : ", values not yet checked on a panel");
+    }
+
+    void sendCommands(const uint8_t *commands, int count)
+    {
+        dcOut = 0;
+        csOut = 0;
+        for (int i=0; i < count; i++) spi.write(commands[i]);
+        csOut = 1;
+    }
+
+    // Where the character's columns are in the font. False if it has none, eg. space.
+    bool glyph(char character, int &start, int &width)
+    {
+        if (!fontOffsets || character < *fontStartCharacter || character > *fontEndCharacter) return false;
+
+        int index = character - *fontStartCharacter;
+        start = fontOffsets[index];
+        width = fontOffsets[index + 1] - start;
+
+        return true;
+    }
+
+    // Into a row's worth of columns from the left, returning how many were written
+    int renderText(const std::string &message, uint32_t *columnWords)
+    {
+        uint8_t *columns = (uint8_t*)columnWords;
+
+        int x = 0;
+        for (size_t i=0; i < message.length() && x < pixWidth; i++)
+        {
+            int start, width;
+            if (glyph(message[i], start, width))
+            {
+                if (x + width > pixWidth) width = pixWidth - x;
+                memcpy(columns + x, fontColumns + start, width);
+            }
+            else
+            {
+                width = kSPKDisplaySpaceWidth;
+                if (x + width > pixWidth) width = pixWidth - x;
+                memset(columns + x, 0, width);
+            }
+            x += width;
+
+            // The gap between characters
+            if (x < pixWidth) columns[x++] = 0;
+        }
+
+        return x;
+    }
+
+    // Whole words, then the odd columns
+    void columnsToBuffer(const uint32_t *columnWords, int width, int row)
+    {
+        if (width <= 0) return;
+
+        uint32_t *rowWords = bufferWords + row*(pixWidth/4);
+        int wholeWords = width / 4;
+        for (int i=0; i < wholeWords; i++) rowWords[i] = columnWords[i];
+
+        const uint8_t *columns = (const uint8_t*)columnWords;
+        uint8_t *rowColumns = buffer + row*pixWidth;
+        for (int x=wholeWords*4; x < width; x++) rowColumns[x] = columns[x];
+
+        markDirty(row, 0, width - 1);
+    }
+
+    // FNV-1a, so most misses don't need a string compare
+    static uint32_t hashText(const std::string &text)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i=0; i < text.length(); i++)
+        {
+            hash ^= uint8_t(text[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void markDirty(int page, int start, int end)
+    {
+        if (start < dirtyStart[page]) dirtyStart[page] = start;
+        if (end > dirtyEnd[page]) dirtyEnd[page] = end;
+    }
+
+    static void markClean(int *starts, int *ends, int page)
+    {
+        starts[page] = pixWidth;
+        ends[page] = -1;
+    }
+
+    SPI spi;
+    DigitalOut csOut;
+    DigitalOut dcOut;
+    DigitalOut resOut;
+    Serial *debug;
+
+    Ticker frameTicker;
+    int frameMicros;
+    bool running;
+    volatile bool sending;
+
+    // Drawn into, presented, and on the panel or being sent to it. Drawn into by word where it can be.
+    union {
+        uint8_t buffer[bufferCount];
+        uint32_t bufferWords[bufferCount / 4];
+    };
+    uint8_t ready[bufferCount];
+    uint8_t panel[bufferCount];
+
+    // Column ranges changed in each, by page
+    int dirtyStart[pixPages];
+    int dirtyEnd[pixPages];
+    int readyStart[pixPages];
+    int readyEnd[pixPages];
+    int windowStart[pixPages];
+    int windowEnd[pixPages];
+    int windowPage;
+
+    struct labelType {
+        std::string text;
+        uint32_t hash;
+        int width;
+        uint32_t lastUsed;
+        uint32_t columns[pixWidth / 4];
+    };
+
+    labelType labels[kSPKDisplayLabelCacheSize];
+    uint32_t labelUseCount;
+    uint32_t lineWords[pixWidth / 4];
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "mbed.h"
 #include "ipaddr.h"
+#include "spk_fader_curve.h"
 #include <string>
 #include <vector>
 
@@ -39,6 +40,22 @@ public:
         int outChannelFadeUp;
     } dmx;
     
+    struct {
+        bool enabled;
+        int latencyPercent;
+        int maxLeadMillis;
+    } prediction;
+    
+    struct {
+        int durationMillis;
+        string curveName;
+    } transition;
+    
+    struct {
+        int frameRateHz;
+        bool meters;
+    } display;
+    
     SPKSettings()
     {
         editingKeyerSetIndex = -1;
@@ -67,6 +84,22 @@ public:
         dmx.inChannelFadeUp = 1;
         dmx.outChannelXFade = 0;
         dmx.outChannelFadeUp = 1;
+        
+        //// PREDICTION
+        
+        prediction.enabled = false;
+        prediction.latencyPercent = 50;
+        prediction.maxLeadMillis = 60;
+        
+        //// TRANSITION
+        
+        transition.durationMillis = 2000;
+        transition.curveName = "S-Curve";
+        
+        //// DISPLAY
+        
+        display.frameRateHz = 30;
+        display.meters = true;
     
         //// KEYS
         
@@ -101,6 +134,23 @@ public:
         keyerParamSets.push_back(paramSet);
         keyerParamNames.push_back("Chromakey - Blue");
         
+        //// CURVES
+        
+        faderCurves.clear();
+        faderCurves.push_back(SPKFaderCurve("Linear", SPKFaderCurve::faderBoth));
+        
+        SPKFaderCurve curve("S-Curve", SPKFaderCurve::faderBoth);
+        curve.compileS();
+        faderCurves.push_back(curve);
+        
+        curve = SPKFaderCurve("Log", SPKFaderCurve::faderFadeUp);
+        curve.compileLog();
+        faderCurves.push_back(curve);
+        
+        curve = SPKFaderCurve("Cut at 10%", SPKFaderCurve::faderXFade);
+        curve.compileCut(10);
+        faderCurves.push_back(curve);
+        
         //// RESOLUTIONS
         
         resolutionNames.clear();
@@ -182,6 +232,31 @@ public:
         }
     }
     
+    string faderCurveName (int index)
+    {
+        return faderCurves[index].name;
+    }
+    
+    SPKFaderCurve& faderCurve(int index)
+    {
+        return faderCurves[index];
+    }
+    
+    int         faderCurveCount()
+    {
+        return faderCurves.size();
+    }
+    
+    // Index of the named curve, or 0 for linear if there's no such curve
+    int         faderCurveIndex(string name)
+    {
+        for (int i=0; i < faderCurveCount(); i++)
+        {
+            if (faderCurves[i].name == name) return i;
+        }
+        return 0;
+    }
+    
     string resolutionName (int index)
     {
         // TODO: Bounds check and return out of bounds name
@@ -290,6 +365,56 @@ public:
             }
         }
             
+        // PREDICTION
+        {
+            int enabled = iniparser_getboolean(settings, "Prediction:Enabled", failInt);
+            int latencyPercent = iniparser_getint(settings, "Prediction:LatencyPercent", failInt);
+            int maxLeadMillis = iniparser_getint(settings, "Prediction:MaxLeadMillis", failInt);
+            
+            bool predictionReadOK = enabled != failInt && latencyPercent >= 0 && maxLeadMillis >= 0;
+            
+            if (predictionReadOK)
+            {
+                prediction.enabled = enabled;
+                prediction.latencyPercent = latencyPercent;
+                prediction.maxLeadMillis = maxLeadMillis;
+                
+                success = true;
+            }
+        }
+            
+        // TRANSITION
+        {
+            int durationMillis = iniparser_getint(settings, "Transition:DurationMillis", failInt);
+            char* curveName = iniparser_getstring(settings, "Transition:Curve", failString);
+            
+            bool transitionReadOK = durationMillis > 0 && strcmp(curveName, failString);
+            
+            if (transitionReadOK)
+            {
+                transition.durationMillis = durationMillis;
+                transition.curveName = curveName;
+                
+                success = true;
+            }
+        }
+            
+        // DISPLAY
+        {
+            int frameRateHz = iniparser_getint(settings, "Display:FrameRate", failInt);
+            int meters = iniparser_getboolean(settings, "Display:Meters", failInt);
+            
+            bool displayReadOK = frameRateHz > 0 && frameRateHz <= 100 && meters != failInt;
+            
+            if (displayReadOK)
+            {
+                display.frameRateHz = frameRateHz;
+                display.meters = meters;
+                
+                success = true;
+            }
+        }
+            
         // KEYER
         {
             int counter = 1;
@@ -369,6 +494,68 @@ public:
             }
         }        
 
+        // CURVES
+        {
+            int counter = 1;
+            
+            bool curveReadOK = true;
+            bool curveCleared = false;
+            
+            const int stringLength = 25;
+            
+            // Loop through Curve1,2,...,99 keys of the [Curves] section
+            while(curveReadOK)
+            {
+                char*   curveName;
+                char*   curveFader;
+                char*   curveShape;
+                char*   curvePoints;
+                
+                char key[stringLength];
+        
+                snprintf(key, stringLength, "Curves:Curve%iName", counter);
+                curveName = iniparser_getstring(settings, key, failString);
+                curveReadOK = curveReadOK && strcmp(curveName, failString);
+                
+                SPKFaderCurve curve(curveReadOK ? curveName : "");
+                
+                snprintf(key, stringLength, "Curves:Curve%iFader", counter);
+                curveFader = iniparser_getstring(settings, key, "Both");
+                curveReadOK = curveReadOK && curve.setFader(curveFader);
+                
+                snprintf(key, stringLength, "Curves:Curve%iShape", counter);
+                curveShape = iniparser_getstring(settings, key, failString);
+                
+                snprintf(key, stringLength, "Curves:Curve%iPoints", counter);
+                curvePoints = iniparser_getstring(settings, key, failString);
+                
+                snprintf(key, stringLength, "Curves:Curve%iThreshold", counter);
+                int curveThreshold = iniparser_getint(settings, key, failInt);
+                
+                curveReadOK = curveReadOK && curve.compile(curveShape, strcmp(curvePoints, failString) ? curvePoints : NULL, curveThreshold);
+                
+                // If all parameters have been read successfully
+                if (curveReadOK)
+                {
+                    // If this is the first time through, clear old values, but keep linear
+                    if (!curveCleared)
+                    {
+                        faderCurves.clear();
+                        faderCurves.push_back(SPKFaderCurve("Linear", SPKFaderCurve::faderBoth));
+                        curveCleared = true;
+                    }
+                
+                    // Apply settings
+                    faderCurves.push_back(curve);
+                    
+                    // We've successfully read a curve, so should return true;
+                    success = true;
+                }
+                
+                counter++;
+            }
+        }
+
         // RESOLUTIONS
         {
             int counter = 1;
@@ -435,6 +622,7 @@ protected:
     LocalFileSystem *local;
     vector< vector<int> >   keyerParamSets;
     vector<string>          keyerParamNames;
+    vector<SPKFaderCurve>   faderCurves;
     vector<string>          resolutionNames;
     vector<int32_t>         resolutionIndexes;
     vector<int32_t>         resolutionEDIDIndexes;
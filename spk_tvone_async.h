@@ -0,0 +1,315 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_ASYNC talks the TVOne RS232 protocol without waiting on the UART.
+// Received characters are put into an SPKTVOneRxBuffer by the RX interrupt, and parsed into acknowledgements whenever poll() is called.
+// Acknowledgements are matched to the outstanding request for the same source, window and function, so several can be in flight at once.
+// SPKTVOne polls the same UART for its own commands, so call release() before using it; the next send() takes the UART back.
+// Construct after the SPKTVOne on the same pins. Opening the pins resets the UART, so the baud and format SPKTVOne set are read first and put back.
+// Given a simulator, frames go to and from that instead of the UART.
+
+#ifndef SPK_TVONE_ASYNC_h
+#define SPK_TVONE_ASYNC_h
+
+#include "mbed.h"
+
+#define kTVOneAsyncMaxInFlight      4
+#define kTVOneAsyncDefaultWindow    2
+#define kTVOneAsyncMaxCompletions   8
+#define kTVOneAsyncDefaultPeriod    30
+#define kTVOneAsyncDefaultTimeout   100
+
+class SPKTVOneAsync {
+public:
+    struct requestType {
+        int     ticket;
+        bool    write;
+        uint8_t source;
+        uint8_t window;
+        int32_t function;
+        int32_t payload;
+        uint32_t sentMillis;
+    };
+
+    struct completionType {
+        requestType request;
+        bool    ok;
+        int32_t payload;
+        int     rttMillis;
+    };
+
+    SPKTVOneAsync(PinName txPin, PinName rxPin, Serial *debugSerial = NULL) : uartSetup(readUARTSetup(txPin)), serial(txPin, rxPin)
+    {
+        debug = debugSerial;
+        if (!writeUARTSetup(uartSetup))
+        {
+            if (debug) debug->printf("TVOne async: UART on pin %i not set up before \r\n", txPin);
+        }
+        pacing = NULL;
+        simulator = NULL;
+        attached = false;
+        inFlightWindow = kTVOneAsyncDefaultWindow;
+        inFlightCount = 0;
+        completionCount = 0;
+        completionFirst = 0;
+        nextTicket = 1;
+        lastSentMillis = 0;
+    }
+
+    void setPacing(SPKTVOnePacing *linkPacing) { pacing = linkPacing; }
+    void setSimulator(SPKTVOneSim *sim)         { simulator = sim; }
+
+    // How many requests can be awaiting acknowledgement at once. The 1T-C2-750 is happy with two.
+    void setWindow(int window)
+    {
+        if (window < 1) window = 1;
+        if (window > kTVOneAsyncMaxInFlight) window = kTVOneAsyncMaxInFlight;
+        inFlightWindow = window;
+    }
+
+    bool canSend()
+    {
+        return (inFlightCount < inFlightWindow) && (completionCount < kTVOneAsyncMaxCompletions - inFlightCount) && (millisSinceLastCommandSent() >= periodMillis());
+    }
+
+    // Returns a ticket to find the result by, or 0 if the link can't take the command yet.
+    int send(bool write, uint8_t source, uint8_t window, int32_t function, int32_t payload)
+    {
+        if (!canSend()) return 0;
+
+        if (!attached && !simulator)
+        {
+            // Anything waiting is left over from SPKTVOne's use of the UART
+            while (serial.readable()) serial.getc();
+            rx.clear();
+            serial.attach(this, &SPKTVOneAsync::onRx, Serial::RxIrq);
+            attached = true;
+        }
+
+        uint8_t cmd[8];
+        cmd[0] = (write ? 1 : 0) << 7 | 1 << 2;
+        cmd[1] = source;
+        cmd[2] = window;
+        cmd[3] = function >> 8;
+        cmd[4] = function & 0xFF;
+        cmd[5] = (payload >> 16) & 0xFF;
+        cmd[6] = (payload >> 8) & 0xFF;
+        cmd[7] = payload & 0xFF;
+
+        uint8_t checksum = 0;
+        int length = write ? 8 : 5;
+
+        putChar('F');
+        for (int i=0; i < length; i++)
+        {
+            putHex(cmd[i]);
+            checksum += cmd[i];
+        }
+        putHex(checksum);
+        putChar('\r');
+
+        requestType &request = inFlight[inFlightCount];
+        request.ticket = nextTicket;
+        request.write = write;
+        request.source = source;
+        request.window = window;
+        request.function = function;
+        request.payload = payload;
+        request.sentMillis = clock.millis();
+        inFlightCount++;
+
+        lastSentMillis = request.sentMillis;
+
+        nextTicket++;
+        if (nextTicket <= 0) nextTicket = 1;
+
+        return request.ticket;
+    }
+
+    // Parse what has been received, and time out anything that has waited too long.
+    void poll()
+    {
+        char c;
+        SPKTVOneFrameParser::frameType frame;
+
+        if (simulator)
+        {
+            while (simulator->read(c)) rx.put(c);
+        }
+
+        while (rx.get(c))
+        {
+            if (parser.feed(c, frame)) acknowledge(frame);
+        }
+
+        uint32_t now = clock.millis();
+        int timeout = timeoutMillis();
+
+        while (inFlightCount > 0 && (now - inFlight[0].sentMillis > uint32_t(timeout)))
+        {
+            if (debug) debug->printf("TVOne async: timeout on %#x \r\n", inFlight[0].function);
+            complete(0, false, 0);
+        }
+    }
+
+    bool nextCompletion(completionType &completion)
+    {
+        if (completionCount == 0) return false;
+
+        completion = completions[completionFirst];
+        completionFirst = (completionFirst + 1) % kTVOneAsyncMaxCompletions;
+        completionCount--;
+
+        return true;
+    }
+
+    int inFlightRequests() { return inFlightCount; }
+
+    // Wait for everything in flight, then hand the UART back to SPKTVOne.
+    void release()
+    {
+        while (inFlightCount > 0) poll();
+
+        if (attached)
+        {
+            serial.attach(NULL, Serial::RxIrq);
+            attached = false;
+        }
+    }
+
+    int millisSinceLastCommandSent()
+    {
+        return clock.millis() - lastSentMillis;
+    }
+
+private:
+    struct uartSetupType {
+        LPC_UART_TypeDef *uart;
+        uint8_t lcr;
+        uint8_t dll;
+        uint8_t dlm;
+        uint8_t fdr;
+    };
+
+    // Divisor latches and fractional divider are what set the baud, line control the format
+    static uartSetupType readUARTSetup(PinName txPin)
+    {
+        uartSetupType setup;
+        uint32_t powerBit;
+
+        switch (txPin)
+        {
+            case USBTX: setup.uart = LPC_UART0;                       powerBit = 1 << 3;  break;
+            case p13:   setup.uart = (LPC_UART_TypeDef *)LPC_UART1;   powerBit = 1 << 4;  break;
+            case p28:   setup.uart = LPC_UART2;                       powerBit = 1 << 24; break;
+            case p9:    setup.uart = LPC_UART3;                       powerBit = 1 << 25; break;
+            default:    setup.uart = NULL;                            powerBit = 0;
+        }
+
+        // Unpowered, the UART hasn't been set up and its registers can't be read
+        if (!(LPC_SC->PCONP & powerBit)) setup.uart = NULL;
+        if (!setup.uart) return setup;
+
+        __disable_irq();
+        setup.lcr = setup.uart->LCR & 0x7F;
+        setup.uart->LCR = setup.lcr | 0x80;
+        setup.dll = setup.uart->DLL;
+        setup.dlm = setup.uart->DLM;
+        setup.uart->LCR = setup.lcr;
+        setup.fdr = setup.uart->FDR;
+        __enable_irq();
+
+        if (setup.dll == 0 && setup.dlm == 0) setup.uart = NULL;
+
+        return setup;
+    }
+
+    static bool writeUARTSetup(const uartSetupType &setup)
+    {
+        if (!setup.uart) return false;
+
+        __disable_irq();
+        setup.uart->LCR = setup.lcr | 0x80;
+        setup.uart->DLL = setup.dll;
+        setup.uart->DLM = setup.dlm;
+        setup.uart->LCR = setup.lcr;
+        setup.uart->FDR = setup.fdr;
+        __enable_irq();
+
+        return true;
+    }
+
+    void onRx()
+    {
+        while (serial.readable()) rx.put(serial.getc());
+    }
+
+    void putChar(char c)
+    {
+        if (simulator) simulator->write(c);
+        else serial.putc(c);
+    }
+
+    void putHex(uint8_t byte)
+    {
+        const char hex[] = "0123456789ABCDEF";
+        putChar(hex[byte >> 4]);
+        putChar(hex[byte & 0xF]);
+    }
+
+    int periodMillis()  { return pacing ? pacing->commandPeriodMillis() : kTVOneAsyncDefaultPeriod; }
+    int timeoutMillis() { return pacing ? pacing->commandTimeoutMillis() : kTVOneAsyncDefaultTimeout; }
+
+    void acknowledge(const SPKTVOneFrameParser::frameType &frame)
+    {
+        // The processor answers in order, so take the oldest match
+        for (int i=0; i < inFlightCount; i++)
+        {
+            requestType &request = inFlight[i];
+            if (request.function == frame.function && request.window == frame.window && request.source == frame.source)
+            {
+                complete(i, (frame.status >> 4) == 4, frame.payload);
+                return;
+            }
+        }
+
+        if (debug) debug->printf("TVOne async: unmatched ack for %#x \r\n", frame.function);
+    }
+
+    void complete(int index, bool ok, int32_t payload)
+    {
+        completionType &completion = completions[(completionFirst + completionCount) % kTVOneAsyncMaxCompletions];
+        completion.request = inFlight[index];
+        completion.ok = ok;
+        completion.payload = payload;
+        completion.rttMillis = clock.millis() - inFlight[index].sentMillis;
+        completionCount++;
+
+        if (pacing) pacing->sample(completion.rttMillis, 0, ok);
+
+        for (int i=index; i < inFlightCount-1; i++) inFlight[i] = inFlight[i+1];
+        inFlightCount--;
+    }
+
+    uartSetupType uartSetup; // Before serial, so read before it resets the UART
+    Serial serial;
+    Serial *debug;
+    SPKTVOnePacing *pacing;
+    SPKTVOneSim *simulator;
+    SPKClock clock;
+    SPKTVOneRxBuffer rx;
+    SPKTVOneFrameParser parser;
+
+    bool attached;
+    int inFlightWindow;
+    requestType inFlight[kTVOneAsyncMaxInFlight];
+    int inFlightCount;
+    completionType completions[kTVOneAsyncMaxCompletions];
+    int completionFirst;
+    int completionCount;
+    int nextTicket;
+    uint32_t lastSentMillis;
+};
+
+#endif
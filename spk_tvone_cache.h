@@ -0,0 +1,387 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_CACHE shadows the processor registers the controller touches, so status checks needn't cost an RS232 round-trip.
+// Writes go through to the processor and update the shadow. Reads are served from the shadow unless the value is invalid or stale.
+// Call verifyNext() when the link is idle: it re-reads the least recently verified register, at most one per verify period.
+// Anything that changes registers behind our back -- presets, resolution, aspect, HDCP -- should invalidate().
+// If given a pacing controller, every command sent through here is timed for it.
+// If given an async link, commands go through that instead of SPKTVOne, and send() can write without waiting for the acknowledgement.
+// readCommands() takes a list of registers, and with an async link has them all in flight together rather than one after another.
+
+#ifndef SPK_TVONE_CACHE_h
+#define SPK_TVONE_CACHE_h
+
+#include "mbed.h"
+
+#define kTVOneCacheSize 48
+#define kTVOneCacheBatchSize 16
+
+class SPKTVOneCache {
+public:
+    // Set live for status that changes on the processor's side. Payload is only written if the read succeeds.
+    struct readType { uint8_t source; uint8_t window; int32_t function; int32_t payload; bool live; };
+
+    SPKTVOneCache(SPKTVOne *tvOneLink, int staleMillis = 60000, int verifyPeriodMillis = 2000, Serial *debugSerial = NULL)
+    {
+        tvOne = tvOneLink;
+        pacing = NULL;
+        async = NULL;
+        debug = debugSerial;
+        registerCount = 0;
+        staleMillisPeriod = staleMillis;
+        verifyMillisPeriod = verifyPeriodMillis;
+        lastVerifyMillis = 0;
+    }
+
+    void setPacing(SPKTVOnePacing *linkPacing) { pacing = linkPacing; }
+    void setAsync(SPKTVOneAsync *asyncLink)     { async = asyncLink; }
+    void setStalePeriod(int millis)     { staleMillisPeriod = millis; }
+    void setVerifyPeriod(int millis)    { verifyMillisPeriod = millis; }
+
+    bool command(uint8_t source, uint8_t window, int32_t function, int32_t payload)
+    {
+        bool ok = linkCommand(source, window, function, payload);
+
+        if (isAction(function))
+        {
+            // Recalling a preset changes everything
+            if (ok && function == kTV1FunctionPreset) invalidate();
+        }
+        else
+        {
+            registerType *reg = registerFor(source, window, function, true);
+            if (reg) store(reg, payload, ok);
+        }
+
+        return ok;
+    }
+
+    // Write without waiting. Returns false if the link can't take it yet. The shadow is updated when the acknowledgement arrives.
+    // If that acknowledgement is an error or never comes, writeFailed() says so.
+    bool send(uint8_t source, uint8_t window, int32_t function, int32_t payload)
+    {
+        if (!async) return command(source, window, function, payload);
+
+        poll();
+        int ticket = async->send(true, source, window, function, payload);
+        if (!ticket) return false;
+
+        registerType *reg = registerFor(source, window, function, true);
+        if (reg)
+        {
+            reg->sentTicket = ticket;
+            reg->sendFailed = false;
+        }
+        return true;
+    }
+
+    // True once, if the last send() to the register completed with an error. Call after poll().
+    bool writeFailed(uint8_t source, uint8_t window, int32_t function)
+    {
+        registerType *reg = registerFor(source, window, function, false);
+        if (!reg || !reg->sendFailed) return false;
+
+        reg->sendFailed = false;
+        return true;
+    }
+
+    // Take in any acknowledgements that have arrived. Call once per pass.
+    void poll()
+    {
+        if (!async) return;
+
+        async->poll();
+
+        SPKTVOneAsync::completionType completion;
+        while (async->nextCompletion(completion)) apply(completion);
+    }
+
+    bool readCommand(uint8_t source, uint8_t window, int32_t function, int32_t &payload)
+    {
+        registerType *reg = registerFor(source, window, function, true);
+
+        if (isFresh(reg))
+        {
+            payload = reg->payload;
+            return true;
+        }
+
+        return readLive(source, window, function, payload);
+    }
+
+    // For status that changes on the processor's side, ie. source stable.
+    bool readLive(uint8_t source, uint8_t window, int32_t function, int32_t &payload)
+    {
+        int32_t livePayload;
+        bool ok = linkReadCommand(source, window, function, livePayload);
+        if (ok) payload = livePayload;
+
+        registerType *reg = registerFor(source, window, function, true);
+        if (reg) store(reg, livePayload, ok);
+
+        return ok;
+    }
+
+    // Returns true only if every read succeeded.
+    bool readCommands(readType *reads, int count)
+    {
+        bool ok = true;
+        for (int first=0; first < count; first += kTVOneCacheBatchSize)
+        {
+            int batch = count - first;
+            if (batch > kTVOneCacheBatchSize) batch = kTVOneCacheBatchSize;
+            ok = readBatch(&reads[first], batch) && ok;
+        }
+        return ok;
+    }
+
+    // Re-read one register if the verify period has passed. Returns true if it read from the processor.
+    bool verifyNext()
+    {
+        uint32_t now = clock.millis();
+        if (now - lastVerifyMillis < uint32_t(verifyMillisPeriod)) return false;
+
+        registerType *oldest = NULL;
+        for (int i=0; i < registerCount; i++)
+        {
+            if (!oldest || (registers[i].verifiedMillis < oldest->verifiedMillis)) oldest = &registers[i];
+        }
+        if (!oldest) return false;
+
+        lastVerifyMillis = now;
+
+        int32_t payload;
+        bool ok = linkReadCommand(oldest->source, oldest->window, oldest->function, payload);
+
+        if (ok && oldest->valid && payload != oldest->payload && debug)
+        {
+            debug->printf("TVOne cache: %#x %#x %#x was %i now %i \r\n", oldest->source, oldest->window, oldest->function, oldest->payload, payload);
+        }
+        store(oldest, payload, ok);
+
+        return true;
+    }
+
+    void invalidate()
+    {
+        for (int i=0; i < registerCount; i++) registers[i].valid = false;
+    }
+
+    void invalidate(uint8_t source, uint8_t window, int32_t function)
+    {
+        registerType *reg = registerFor(source, window, function, false);
+        if (reg) reg->valid = false;
+    }
+
+private:
+    struct registerType
+    {
+        uint8_t source;
+        uint8_t window;
+        int32_t function;
+        int32_t payload;
+        bool    valid;
+        uint32_t verifiedMillis;
+        int     sentTicket;
+        bool    sendFailed;
+    };
+
+    bool linkCommand(uint8_t source, uint8_t window, int32_t function, int32_t payload)
+    {
+        if (async) return linkAsync(true, source, window, function, payload);
+
+        int held = pacing ? pacing->holdMillis() : 0;
+        uint32_t startMicros = clock.micros();
+
+        bool ok = tvOne->command(source, window, function, payload);
+
+        if (pacing) pacing->sample((clock.micros() - startMicros) / 1000, held, ok);
+        return ok;
+    }
+
+    bool linkReadCommand(uint8_t source, uint8_t window, int32_t function, int32_t &payload)
+    {
+        if (async) return linkAsync(false, source, window, function, payload);
+
+        int held = pacing ? pacing->holdMillis() : 0;
+        uint32_t startMicros = clock.micros();
+
+        bool ok = tvOne->readCommand(source, window, function, payload);
+
+        if (pacing) pacing->sample((clock.micros() - startMicros) / 1000, held, ok);
+        return ok;
+    }
+
+    // Blocks until the request is answered or times out, but on the processor's RTT rather than SPKTVOne's fixed waits.
+    // The async link times itself for pacing.
+    bool linkAsync(bool write, uint8_t source, uint8_t window, int32_t function, int32_t &payload)
+    {
+        int ticket = 0;
+        while (!ticket)
+        {
+            poll();
+            ticket = async->send(write, source, window, function, payload);
+        }
+
+        while (true)
+        {
+            async->poll();
+
+            SPKTVOneAsync::completionType completion;
+            while (async->nextCompletion(completion))
+            {
+                apply(completion);
+                if (completion.request.ticket == ticket)
+                {
+                    if (completion.ok && !write) payload = completion.payload;
+                    return completion.ok;
+                }
+            }
+        }
+    }
+
+    void apply(const SPKTVOneAsync::completionType &completion)
+    {
+        const SPKTVOneAsync::requestType &request = completion.request;
+
+        if (isAction(request.function))
+        {
+            if (completion.ok && request.function == kTV1FunctionPreset) invalidate();
+            return;
+        }
+
+        registerType *reg = registerFor(request.source, request.window, request.function, true);
+        if (!reg) return;
+
+        store(reg, request.write ? request.payload : completion.payload, completion.ok);
+
+        // Only the latest send() matters, anything older has been superseded
+        if (request.ticket == reg->sentTicket)
+        {
+            reg->sentTicket = 0;
+            reg->sendFailed = !completion.ok;
+        }
+    }
+
+    bool readBatch(readType *reads, int count)
+    {
+        // Ticket per read: -1 to send, 0 done, otherwise in flight
+        int tickets[kTVOneCacheBatchSize];
+        int waiting = 0;
+        bool ok = true;
+
+        for (int i=0; i < count; i++)
+        {
+            readType &read = reads[i];
+            registerType *reg = registerFor(read.source, read.window, read.function, true);
+
+            tickets[i] = 0;
+            if (!read.live && isFresh(reg))     read.payload = reg->payload;
+            else if (!async)                    ok = readLive(read.source, read.window, read.function, read.payload) && ok;
+            else                                { tickets[i] = -1; waiting++; }
+        }
+
+        int next = 0;
+        while (waiting > 0)
+        {
+            // Keep as many in flight as the link will take
+            while (next < count)
+            {
+                if (tickets[next] == -1)
+                {
+                    int ticket = async->send(false, reads[next].source, reads[next].window, reads[next].function, 0);
+                    if (!ticket) break;
+                    tickets[next] = ticket;
+                }
+                next++;
+            }
+
+            async->poll();
+
+            SPKTVOneAsync::completionType completion;
+            while (async->nextCompletion(completion))
+            {
+                apply(completion);
+                for (int i=0; i < count; i++)
+                {
+                    if (tickets[i] > 0 && tickets[i] == completion.request.ticket)
+                    {
+                        if (completion.ok) reads[i].payload = completion.payload;
+                        ok = ok && completion.ok;
+                        tickets[i] = 0;
+                        waiting--;
+                    }
+                }
+            }
+        }
+
+        return ok;
+    }
+
+    bool isFresh(registerType *reg)
+    {
+        return reg && reg->valid && (clock.millis() - reg->verifiedMillis < uint32_t(staleMillisPeriod));
+    }
+
+    bool isAction(int32_t function)
+    {
+        return (function == kTV1FunctionPreset) || (function == kTV1FunctionPresetStore) || (function == kTV1FunctionPowerOnPresetStore);
+    }
+
+    void store(registerType *reg, int32_t payload, bool ok)
+    {
+        reg->valid = ok;
+        if (ok) reg->payload = payload;
+        reg->verifiedMillis = clock.millis();
+    }
+
+    registerType *registerFor(uint8_t source, uint8_t window, int32_t function, bool create)
+    {
+        for (int i=0; i < registerCount; i++)
+        {
+            registerType *reg = &registers[i];
+            if (reg->source == source && reg->window == window && reg->function == function) return reg;
+        }
+
+        if (!create) return NULL;
+
+        registerType *reg;
+        if (registerCount < kTVOneCacheSize)
+        {
+            reg = &registers[registerCount];
+            registerCount++;
+        }
+        else
+        {
+            // Full, so recycle the least recently verified
+            reg = &registers[0];
+            for (int i=1; i < registerCount; i++) if (registers[i].verifiedMillis < reg->verifiedMillis) reg = &registers[i];
+        }
+
+        reg->source = source;
+        reg->window = window;
+        reg->function = function;
+        reg->payload = 0;
+        reg->valid = false;
+        reg->verifiedMillis = clock.millis();
+        reg->sentTicket = 0;
+        reg->sendFailed = false;
+
+        return reg;
+    }
+
+    SPKTVOne *tvOne;
+    SPKTVOnePacing *pacing;
+    SPKTVOneAsync *async;
+    Serial *debug;
+    SPKClock clock;
+    registerType registers[kTVOneCacheSize];
+    int registerCount;
+    int staleMillisPeriod;
+    int verifyMillisPeriod;
+    uint32_t lastVerifyMillis;
+};
+
+#endif
@@ -0,0 +1,140 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_FRAME has the pieces for receiving the TVOne RS232 protocol a character at a time.
+// Frames, as per SPKTVOne, are 'F' then hex pairs then '\r'.
+// Command: [cmd][source][window][function hi][function lo]([payload 2][payload 1][payload 0])[checksum], cmd 0x84 write, 0x04 read
+// Acknowledgement: as a write command, with cmd 0x4X on success.
+
+#ifndef SPK_TVONE_FRAME_h
+#define SPK_TVONE_FRAME_h
+
+#include "mbed.h"
+
+#define kTVOneRxBufferSize 128 // Must be a power of two
+
+// Single producer (ie. RX interrupt), single consumer (main loop). No locking needed, as each index is only written by one side.
+class SPKTVOneRxBuffer {
+public:
+    SPKTVOneRxBuffer() {
+        head = 0;
+        tail = 0;
+        overflowCount = 0;
+    }
+
+    void put(char c) {
+        uint32_t next = (head + 1) & (kTVOneRxBufferSize - 1);
+        if (next == tail) {
+            overflowCount++;
+            return;
+        }
+        buffer[head] = c;
+        head = next;
+    }
+
+    bool get(char &c) {
+        if (tail == head) return false;
+        c = buffer[tail];
+        tail = (tail + 1) & (kTVOneRxBufferSize - 1);
+        return true;
+    }
+
+    void clear() {
+        tail = head;
+    }
+
+    int overflows() {
+        return overflowCount;
+    }
+
+private:
+    volatile char buffer[kTVOneRxBufferSize];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile int overflowCount;
+};
+
+// Fed one character at a time, returns true when that character completes a frame.
+// Parses read commands too, which have no payload, for the simulator's side of the link.
+class SPKTVOneFrameParser {
+public:
+    struct frameType {
+        uint8_t status;
+        uint8_t source;
+        uint8_t window;
+        int32_t function;
+        int32_t payload;
+        bool    hasPayload;
+    };
+
+    SPKTVOneFrameParser() {
+        hexCount = -1;
+        errorCount = 0;
+    }
+
+    bool feed(char c, frameType &frame) {
+        // 'F' is also a hex digit, so only starts a frame between frames. Anything else there is noise.
+        if (hexCount < 0) {
+            if (c == 'F') hexCount = 0;
+            return false;
+        }
+
+        if (c == '\r') {
+            bool complete = (hexCount == kFrameHexLength) || (hexCount == kReadFrameHexLength);
+            if (complete) complete = decode(frame);
+            if (!complete) errorCount++;
+            hexCount = -1;
+            return complete;
+        }
+
+        int nibble = hexValue(c);
+        if (nibble < 0 || hexCount == kFrameHexLength) {
+            errorCount++;
+            hexCount = -1;
+            return false;
+        }
+
+        if (hexCount % 2 == 0) bytes[hexCount/2] = nibble << 4;
+        else bytes[hexCount/2] |= nibble;
+        hexCount++;
+
+        return false;
+    }
+
+    int errors() {
+        return errorCount;
+    }
+
+private:
+    enum { kFrameHexLength = 18, kReadFrameHexLength = 12 };
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    // Returns false if the checksum, the low byte of the sum of the bytes before it, doesn't match
+    bool decode(frameType &frame) {
+        int length = hexCount/2 - 1;
+        uint8_t checksum = 0;
+        for (int i=0; i < length; i++) checksum += bytes[i];
+        if (checksum != bytes[length]) return false;
+
+        frame.status = bytes[0];
+        frame.source = bytes[1];
+        frame.window = bytes[2];
+        frame.function = (bytes[3] << 8) | bytes[4];
+        frame.hasPayload = (hexCount == kFrameHexLength);
+        frame.payload = frame.hasPayload ? (bytes[5] << 16) | (bytes[6] << 8) | bytes[7] : 0;
+        return true;
+    }
+
+    uint8_t bytes[kFrameHexLength/2];
+    int hexCount;
+    int errorCount;
+};
+
+#endif
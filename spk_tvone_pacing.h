@@ -0,0 +1,145 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_PACING sets the TVOne link's command period and timeout from measured round-trip times, rather than fixed values.
+// It keeps a smoothed RTT and RTT variance as TCP does (RFC 6298), so the link runs as fast as the processor's firmware allows.
+// A failed command backs off both the period and timeout, which then relax a little with each success, rather than snapping back.
+
+#ifndef SPK_TVONE_PACING_h
+#define SPK_TVONE_PACING_h
+
+#include "mbed.h"
+
+#define kTVOnePacingMinPeriod       5
+#define kTVOnePacingMaxPeriod       500
+#define kTVOnePacingMinTimeout      50
+#define kTVOnePacingMaxTimeout      2000
+#define kTVOnePacingInitialPeriod   30
+#define kTVOnePacingInitialTimeout  100
+#define kTVOnePacingMaxBackoff      1500
+
+class SPKTVOnePacing {
+public:
+    SPKTVOnePacing(SPKTVOne *tvOneLink)
+    {
+        tvOne = tvOneLink;
+        srttEighths = 0;
+        rttVarQuarters = 0;
+        backoffMillis = 0;
+        hasSample = false;
+        sampleCount = 0;
+        failCount = 0;
+        periodMillis = -1;
+        timeoutMillis = -1;
+        apply(kTVOnePacingInitialPeriod, kTVOnePacingInitialTimeout);
+    }
+
+    // Call just before sending. Returns how long the link will hold the command back to honour the current period.
+    int holdMillis()
+    {
+        int hold = periodMillis - tvOne->millisSinceLastCommandSent();
+        return hold > 0 ? hold : 0;
+    }
+
+    // Call with the total time command() or readCommand() took, and the hold returned by holdMillis() beforehand.
+    void sample(int commandMillis, int heldMillis, bool ok)
+    {
+        sampleCount++;
+        if (!ok) failCount++;
+
+        if (ok)
+        {
+            int rtt = commandMillis - heldMillis;
+            if (rtt < 0) rtt = 0;
+
+            // Smoothed RTT kept in 1/8ms and variance in 1/4ms, so the gains of 1/8 and 1/4 are integer shifts
+            if (!hasSample)
+            {
+                srttEighths = rtt << 3;
+                rttVarQuarters = rtt << 1;
+                hasSample = true;
+            }
+            else
+            {
+                int error = rtt - (srttEighths >> 3);
+                srttEighths += error;
+                if (error < 0) error = -error;
+                rttVarQuarters += error - (rttVarQuarters >> 2);
+            }
+
+            // Rounded up, so it decays all the way to 0 rather than settling at 7
+            backoffMillis -= (backoffMillis + 7) >> 3;
+        }
+        else
+        {
+            backoffMillis = backoffMillis * 2 + kTVOnePacingMinPeriod;
+            if (backoffMillis > kTVOnePacingMaxBackoff) backoffMillis = kTVOnePacingMaxBackoff;
+        }
+
+        update();
+    }
+
+    int smoothedRTTMillis() { return srttEighths >> 3; }
+    int rttVarianceMillis() { return rttVarQuarters >> 2; }
+    int commandPeriodMillis() { return periodMillis; }
+    int commandTimeoutMillis() { return timeoutMillis; }
+    int currentBackoffMillis() { return backoffMillis; }
+    bool isBackingOff() { return backoffMillis > kTVOnePacingMinPeriod; }
+
+    // Running totals, to take an error rate over any interval from the difference
+    uint32_t samplesTaken() { return sampleCount; }
+    uint32_t samplesFailed() { return failCount; }
+
+private:
+    void update()
+    {
+        if (!hasSample)
+        {
+            apply(kTVOnePacingInitialPeriod + backoffMillis, kTVOnePacingInitialTimeout + backoffMillis);
+            return;
+        }
+
+        int srtt = srttEighths >> 3;
+        int rttVar = rttVarQuarters >> 2;
+
+        // A jittery processor is a busy processor, so give it breathing room in proportion
+        int period = rttVar + backoffMillis;
+
+        // Long enough to catch all but the tail of the RTT distribution
+        int timeout = srtt + 4*rttVar + backoffMillis;
+
+        apply(period, timeout);
+    }
+
+    void apply(int period, int timeout)
+    {
+        if (period < kTVOnePacingMinPeriod) period = kTVOnePacingMinPeriod;
+        if (period > kTVOnePacingMaxPeriod) period = kTVOnePacingMaxPeriod;
+        if (timeout < kTVOnePacingMinTimeout) timeout = kTVOnePacingMinTimeout;
+        if (timeout > kTVOnePacingMaxTimeout) timeout = kTVOnePacingMaxTimeout;
+
+        if (period != periodMillis)
+        {
+            periodMillis = period;
+            tvOne->setCommandMinimumPeriod(periodMillis);
+        }
+        if (timeout != timeoutMillis)
+        {
+            timeoutMillis = timeout;
+            tvOne->setCommandTimeoutPeriod(timeoutMillis);
+        }
+    }
+
+    SPKTVOne *tvOne;
+    int srttEighths;
+    int rttVarQuarters;
+    int backoffMillis;
+    bool hasSample;
+    uint32_t sampleCount;
+    uint32_t failCount;
+    int periodMillis;
+    int timeoutMillis;
+};
+
+#endif
@@ -0,0 +1,283 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_QUEUE sits in front of the TVOne link and holds outbound fade level commands until the link is free.
+// Pending MaxFadeLevel writes are coalesced per window, so however fast the fader moves only the newest value is sent.
+// The main loop sets levels whenever it likes, and calls service() once per pass to send at most one command.
+// With an async link, service() doesn't wait for the acknowledgement, so the mix loop never stalls on the UART.
+// A fade whose acknowledgement comes back as an error, or not at all, is made pending again, unless a newer level already is.
+// Other parameters, ie. keyer values set from the encoder, are coalesced the same way but sent at most once per parameter period.
+// Once a parameter has been left alone for the settle period it is read back, and re-sent if the processor doesn't agree.
+// A failed read waits another settle period to try again, and after a few tries either way the processor's value is accepted.
+// The link is shared by priority: live fades, then interactive edits, then housekeeping reads, then bulk work.
+// Housekeeping should only run when isClearFor() it, and bulk work should flushAbove() itself between chunks.
+
+#ifndef SPK_TVONE_QUEUE_h
+#define SPK_TVONE_QUEUE_h
+
+#include "mbed.h"
+
+#define kTVOneQueueParameterCount           8
+#define kTVOneQueueParameterPeriodMillis    50
+#define kTVOneQueueParameterSettleMillis    300
+#define kTVOneQueueParameterConfirmTries    3   // Then the processor's value is taken, ie. it clamps what was sent
+
+class SPKTVOneQueue {
+public:
+    enum priorityType { priorityFade, priorityInteractive, priorityHousekeeping, priorityBulk };
+
+    SPKTVOneQueue(SPKTVOneCache *tvOneLink)
+    {
+        tvOne = tvOneLink;
+
+        fades[0].window = kTV1WindowIDA;
+        fades[1].window = kTV1WindowIDB;
+        for (int i=0; i < kFadeCount; i++)
+        {
+            fades[i].level = 0;
+            fades[i].pending = false;
+        }
+
+        parameterCount = 0;
+        lastParameterSentMillis = 0;
+    }
+
+    void setFadeLevel(int32_t window, int32_t level)
+    {
+        fadeType *fade = fadeForWindow(window);
+        if (fade)
+        {
+            fade->level = level;
+            fade->pending = true;
+        }
+    }
+
+    void setParameter(uint8_t source, uint8_t window, int32_t function, int32_t value)
+    {
+        parameterType *parameter = parameterFor(source, window, function);
+        if (!parameter)
+        {
+            // No room to hold it, so just send it
+            tvOne->command(source, window, function, value);
+            return;
+        }
+
+        parameter->value = value;
+        parameter->pending = true;
+        parameter->confirm = true;
+        parameter->confirmTries = 0;
+        parameter->changedMillis = clock.millis();
+    }
+
+    // True if nothing that should go before work of the given priority is waiting.
+    bool isClearFor(priorityType priority)
+    {
+        if (priority > priorityFade)
+        {
+            for (int i=0; i < kFadeCount; i++) if (fades[i].pending) return false;
+        }
+        if (priority > priorityInteractive)
+        {
+            for (int i=0; i < parameterCount; i++) if (parameters[i].pending) return false;
+        }
+        return true;
+    }
+
+    // Send the next pending fade or parameter, if the link can take it. Fades go first.
+    // Returns false only if a command was sent and failed.
+    bool service()
+    {
+        for (int i=0; i < kFadeCount; i++)
+        {
+            if (tvOne->writeFailed(0, fades[i].window, kTV1FunctionAdjustWindowsMaxFadeLevel)) fades[i].pending = true;
+        }
+
+        fadeType *fade = nextFade();
+        if (fade)
+        {
+            // If the link is busy leave the level pending, to try again on the next pass
+            if (tvOne->send(0, fade->window, kTV1FunctionAdjustWindowsMaxFadeLevel, fade->level)) fade->pending = false;
+            return true;
+        }
+
+        uint32_t now = clock.millis();
+
+        parameterType *parameter = nextParameter();
+        if (parameter && (now - lastParameterSentMillis >= kTVOneQueueParameterPeriodMillis))
+        {
+            if (tvOne->send(parameter->source, parameter->window, parameter->function, parameter->value))
+            {
+                parameter->pending = false;
+                lastParameterSentMillis = now;
+            }
+            return true;
+        }
+
+        // The knob has stopped, so check the processor ended up where we left it
+        for (int i=0; i < parameterCount; i++)
+        {
+            parameterType &settled = parameters[i];
+            if (settled.confirm && !settled.pending && (now - settled.changedMillis >= kTVOneQueueParameterSettleMillis))
+            {
+                return confirmParameter(settled);
+            }
+        }
+
+        return true;
+    }
+
+    // Send everything pending, blocking until acknowledged. Use where command order matters, ie. before a mix mode change.
+    bool flush()
+    {
+        bool ok = true;
+        fadeType *fade;
+        while (ok && (fade = nextFade()))
+        {
+            ok = tvOne->command(0, fade->window, kTV1FunctionAdjustWindowsMaxFadeLevel, fade->level);
+
+            // On failure leave the level pending, to retry on the next pass
+            if (ok) fade->pending = false;
+        }
+        return ok;
+    }
+
+    // Send everything that should go before work of the given priority, blocking until done.
+    // Parameters are confirmed later by service(), as usual.
+    bool flushAbove(priorityType priority)
+    {
+        bool ok = true;
+
+        if (priority > priorityFade) ok = flush();
+
+        if (priority > priorityInteractive)
+        {
+            for (int i=0; ok && i < parameterCount; i++)
+            {
+                parameterType &parameter = parameters[i];
+                if (parameter.pending)
+                {
+                    ok = tvOne->command(parameter.source, parameter.window, parameter.function, parameter.value);
+                    if (ok) parameter.pending = false;
+                }
+            }
+        }
+
+        return ok;
+    }
+
+    // Send and confirm every parameter, blocking until done. Use when the edit is committed, ie. on press.
+    bool flushParameters()
+    {
+        bool ok = true;
+        for (int i=0; ok && i < parameterCount; i++)
+        {
+            parameterType &parameter = parameters[i];
+            if (parameter.pending)
+            {
+                ok = tvOne->command(parameter.source, parameter.window, parameter.function, parameter.value);
+                if (ok) parameter.pending = false;
+            }
+            if (ok && parameter.confirm) ok = confirmParameter(parameter);
+        }
+        return ok;
+    }
+
+private:
+    enum { kFadeCount = 2 };
+    struct fadeType { int32_t window; int32_t level; bool pending; };
+    struct parameterType { uint8_t source; uint8_t window; int32_t function; int32_t value; bool pending; bool confirm; int confirmTries; uint32_t changedMillis; };
+
+    fadeType *fadeForWindow(int32_t window)
+    {
+        for (int i=0; i < kFadeCount; i++) if (fades[i].window == window) return &fades[i];
+        return NULL;
+    }
+
+    // We want to send the higher first, otherwise black flashes can happen on taps
+    fadeType *nextFade()
+    {
+        fadeType *next = NULL;
+        for (int i=0; i < kFadeCount; i++)
+        {
+            if (fades[i].pending && (!next || fades[i].level > next->level)) next = &fades[i];
+        }
+        return next;
+    }
+
+    parameterType *parameterFor(uint8_t source, uint8_t window, int32_t function)
+    {
+        for (int i=0; i < parameterCount; i++)
+        {
+            parameterType *parameter = &parameters[i];
+            if (parameter->source == source && parameter->window == window && parameter->function == function) return parameter;
+        }
+
+        // Reuse a slot that has nothing left to do
+        parameterType *parameter = NULL;
+        for (int i=0; !parameter && i < parameterCount; i++)
+        {
+            if (!parameters[i].pending && !parameters[i].confirm) parameter = &parameters[i];
+        }
+        if (!parameter && parameterCount < kTVOneQueueParameterCount)
+        {
+            parameter = &parameters[parameterCount];
+            parameterCount++;
+        }
+
+        if (parameter)
+        {
+            parameter->source = source;
+            parameter->window = window;
+            parameter->function = function;
+        }
+        return parameter;
+    }
+
+    // Least recently changed first, so every parameter being turned gets a look in
+    parameterType *nextParameter()
+    {
+        parameterType *next = NULL;
+        for (int i=0; i < parameterCount; i++)
+        {
+            if (parameters[i].pending && (!next || parameters[i].changedMillis < next->changedMillis)) next = &parameters[i];
+        }
+        return next;
+    }
+
+    bool confirmParameter(parameterType &parameter)
+    {
+        int32_t payload = -1;
+        bool ok = tvOne->readLive(parameter.source, parameter.window, parameter.function, payload);
+
+        // Either way, don't try again until another settle period has passed
+        parameter.changedMillis = clock.millis();
+        parameter.confirmTries++;
+
+        if (ok)
+        {
+            // If not, send again and check again
+            parameter.pending = (payload != parameter.value);
+            parameter.confirm = parameter.pending;
+        }
+
+        if (parameter.confirm && parameter.confirmTries >= kTVOneQueueParameterConfirmTries)
+        {
+            // The processor won't take the value, or can't be asked, so settle for what it has
+            if (ok) parameter.value = payload;
+            parameter.pending = false;
+            parameter.confirm = false;
+        }
+
+        return ok;
+    }
+
+    SPKTVOneCache *tvOne;
+    SPKClock clock;
+    fadeType fades[kFadeCount];
+    parameterType parameters[kTVOneQueueParameterCount];
+    int parameterCount;
+    uint32_t lastParameterSentMillis;
+};
+
+#endif
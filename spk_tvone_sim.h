@@ -0,0 +1,253 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// SPK_TVONE_SIM stands in for a 1T-C2-750 on the far end of the RS232 link, so the controller's link code can be measured without one.
+// It answers the register protocol the controller uses: window, source, keyer and fade registers, presets, and the 0x298 additive flag.
+// Every register reads back what was last written, other than source stable which reads as 1.
+// Replies are held for a configurable latency plus random jitter, and commands can be dropped at random, as a busy processor might.
+// The transport is in-process: feed it the controller's characters with write(), take its replies with read(), as SPKTVOneAsync does.
+// EDID and image uploads are made by SPKTVOne directly on the UART, so they don't reach the simulator.
+
+#ifndef SPK_TVONE_SIM_h
+#define SPK_TVONE_SIM_h
+
+#include "mbed.h"
+
+#define kTVOneSimRegisterCount  64
+#define kTVOneSimPresetCount    4
+#define kTVOneSimReplyCount     8
+#define kTVOneSimReplyLength    20
+
+class SPKTVOneSim {
+public:
+    SPKTVOneSim(int latencyMillis = 15, int jitterMillis = 5, int dropPercent = 0, uint32_t seed = 1)
+    {
+        latency = latencyMillis;
+        jitter = jitterMillis;
+        drop = dropPercent;
+        random = seed;
+
+        registerCount = 0;
+        presetSelected = 0;
+        for (int i=0; i < kTVOneSimPresetCount; i++) presetStored[i] = false;
+
+        replyCount = 0;
+        replyFirst = 0;
+        replyPosition = 0;
+        lastDueMillis = 0;
+
+        commands = 0;
+        drops = 0;
+    }
+
+    void setLatency(int latencyMillis, int jitterMillis)    { latency = latencyMillis; jitter = jitterMillis; }
+    void setDropPercent(int dropPercent)                    { drop = dropPercent; }
+
+    // Controller to processor
+    void write(char c)
+    {
+        SPKTVOneFrameParser::frameType frame;
+        if (parser.feed(c, frame)) respond(frame);
+    }
+
+    // Processor to controller. Returns false if nothing is due yet.
+    bool read(char &c)
+    {
+        if (replyCount == 0) return false;
+
+        replyType &reply = replies[replyFirst];
+        if (int32_t(clock.millis() - reply.dueMillis) < 0) return false;
+
+        c = reply.frame[replyPosition];
+        replyPosition++;
+
+        if (replyPosition == kTVOneSimReplyLength)
+        {
+            replyPosition = 0;
+            replyFirst = (replyFirst + 1) % kTVOneSimReplyCount;
+            replyCount--;
+        }
+
+        return true;
+    }
+
+    int32_t registerValue(uint8_t source, uint8_t window, int32_t function)
+    {
+        registerType *reg = registerFor(source, window, function, false);
+        return reg ? reg->payload : 0;
+    }
+
+    // On the simulator's clock, see millis()
+    uint32_t registerChangedMillis(uint8_t source, uint8_t window, int32_t function)
+    {
+        registerType *reg = registerFor(source, window, function, false);
+        return reg ? reg->changedMillis : 0;
+    }
+
+    uint32_t millis()   { return clock.millis(); }
+    int commandCount()  { return commands; }
+    int dropCount()     { return drops; }
+    int errorCount()    { return parser.errors(); }
+
+private:
+    struct registerType { uint8_t source; uint8_t window; int32_t function; int32_t payload; uint32_t changedMillis; };
+    struct replyType { char frame[kTVOneSimReplyLength]; uint32_t dueMillis; };
+
+    void respond(const SPKTVOneFrameParser::frameType &frame)
+    {
+        commands++;
+
+        bool write = frame.status & 0x80;
+        int32_t payload = frame.payload;
+
+        // Nothing comes back from a dropped command, so the controller times out
+        if (int(nextRandom() % 100) < drop)
+        {
+            drops++;
+            return;
+        }
+
+        if (frame.function == kTV1FunctionPreset)
+        {
+            if (write) recallPreset(payload);
+            else payload = presetSelected;
+        }
+        else if (frame.function == kTV1FunctionPresetStore || frame.function == kTV1FunctionPowerOnPresetStore)
+        {
+            if (write) storePreset();
+        }
+        else
+        {
+            registerType *reg = registerFor(frame.source, frame.window, frame.function, true);
+            if (reg && write && reg->payload != payload)
+            {
+                reg->payload = payload;
+                reg->changedMillis = clock.millis();
+            }
+            if (reg && !write) payload = reg->payload;
+        }
+
+        queueReply(frame, payload);
+    }
+
+    void queueReply(const SPKTVOneFrameParser::frameType &frame, int32_t payload)
+    {
+        // A full reply queue means the controller isn't listening, so it won't miss the reply
+        if (replyCount == kTVOneSimReplyCount) return;
+
+        replyType &reply = replies[(replyFirst + replyCount) % kTVOneSimReplyCount];
+
+        uint8_t bytes[8];
+        bytes[0] = 0x40 | (frame.status & 0x0F);
+        bytes[1] = frame.source;
+        bytes[2] = frame.window;
+        bytes[3] = frame.function >> 8;
+        bytes[4] = frame.function & 0xFF;
+        bytes[5] = (payload >> 16) & 0xFF;
+        bytes[6] = (payload >> 8) & 0xFF;
+        bytes[7] = payload & 0xFF;
+
+        const char hex[] = "0123456789ABCDEF";
+        uint8_t checksum = 0;
+        reply.frame[0] = 'F';
+        for (int i=0; i < 8; i++)
+        {
+            reply.frame[1 + i*2] = hex[bytes[i] >> 4];
+            reply.frame[2 + i*2] = hex[bytes[i] & 0xF];
+            checksum += bytes[i];
+        }
+        reply.frame[17] = hex[checksum >> 4];
+        reply.frame[18] = hex[checksum & 0xF];
+        reply.frame[19] = '\r';
+
+        // The processor answers in order, however long each takes
+        uint32_t due = clock.millis() + latency + (jitter > 0 ? nextRandom() % (jitter + 1) : 0);
+        if (replyCount > 0 && int32_t(due - lastDueMillis) < 0) due = lastDueMillis;
+        reply.dueMillis = due;
+        lastDueMillis = due;
+
+        replyCount++;
+    }
+
+    void recallPreset(int32_t preset)
+    {
+        if (preset < 0 || preset >= kTVOneSimPresetCount) return;
+        presetSelected = preset;
+
+        if (!presetStored[preset]) return;
+
+        uint32_t now = clock.millis();
+        for (int i=0; i < registerCount; i++)
+        {
+            if (registers[i].payload != presets[preset][i])
+            {
+                registers[i].payload = presets[preset][i];
+                registers[i].changedMillis = now;
+            }
+        }
+    }
+
+    void storePreset()
+    {
+        for (int i=0; i < registerCount; i++) presets[presetSelected][i] = registers[i].payload;
+        presetStored[presetSelected] = true;
+    }
+
+    registerType *registerFor(uint8_t source, uint8_t window, int32_t function, bool create)
+    {
+        for (int i=0; i < registerCount; i++)
+        {
+            registerType *reg = &registers[i];
+            if (reg->source == source && reg->window == window && reg->function == function) return reg;
+        }
+
+        if (!create || registerCount == kTVOneSimRegisterCount) return NULL;
+
+        registerType *reg = &registers[registerCount];
+        reg->source = source;
+        reg->window = window;
+        reg->function = function;
+        reg->payload = (function == kTV1FunctionAdjustSourceSourceStable) ? 1 : 0;
+        reg->changedMillis = clock.millis();
+
+        // Registers created after a preset was stored take their current value in it
+        for (int i=0; i < kTVOneSimPresetCount; i++) presets[i][registerCount] = reg->payload;
+
+        registerCount++;
+
+        return reg;
+    }
+
+    // Numerical Recipes LCG, plenty for latency jitter
+    uint32_t nextRandom()
+    {
+        random = random * 1664525 + 1013904223;
+        return random >> 8;
+    }
+
+    SPKClock clock;
+    SPKTVOneFrameParser parser;
+
+    int latency;
+    int jitter;
+    int drop;
+    uint32_t random;
+
+    registerType registers[kTVOneSimRegisterCount];
+    int registerCount;
+    int32_t presets[kTVOneSimPresetCount][kTVOneSimRegisterCount];
+    bool presetStored[kTVOneSimPresetCount];
+    int presetSelected;
+
+    replyType replies[kTVOneSimReplyCount];
+    int replyFirst;
+    int replyCount;
+    int replyPosition;
+    uint32_t lastDueMillis;
+
+    int commands;
+    int drops;
+};
+
+#endif
@@ -198,6 +198,32 @@ private:
     Timeout signErrorTimeout;
 };
 
+// Millisecond clock that doesn't overflow with the 32-bit microsecond timer beneath it, so long as it's read more often than every half hour.
+class SPKClock {
+public:
+    SPKClock() {
+        millisCount = 0;
+        lastMicros = 0;
+        timer.start();
+    }
+    
+    uint32_t millis() {
+        uint32_t elapsedMillis = (uint32_t(timer.read_us()) - lastMicros) / 1000;
+        millisCount += elapsedMillis;
+        lastMicros += elapsedMillis * 1000;
+        return millisCount;
+    }
+    
+    uint32_t micros() {
+        return timer.read_us();
+    }
+    
+private:
+    Timer timer;
+    uint32_t millisCount;
+    uint32_t lastMicros;
+};
+
 class SPKMessageHold {
 public:
 
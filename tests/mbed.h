@@ -0,0 +1,49 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// Host stand-in for mbed.h, so the headers can be built into the host tests here.
+// The peripherals do nothing, and the registers are plain memory that reads back as written.
+
+#ifndef MBED_H
+#define MBED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+using namespace std;
+
+typedef int PinName;
+enum { NC = -1 };
+
+class Serial { public: Serial(PinName, PinName) {} int printf(const char*, ...) { return 0; } };
+class DigitalOut { public: DigitalOut(PinName) {} DigitalOut& operator=(int) { return *this; } };
+class SPI { public: SPI(PinName, PinName, PinName) {} void format(int, int = 0) {} void frequency(int) {} int write(int) { return 0; } };
+class Ticker { public: template<class T> void attach_us(T*, void (T::*)(void), unsigned) {} void detach() {} };
+
+inline void wait_ms(int) {}
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+
+struct LPC_SC_TypeDef { volatile uint32_t PCONP; };
+struct LPC_SSP_TypeDef { volatile uint32_t CR0, CR1, DR, SR, CPSR, IMSC, RIS, MIS, ICR, DMACR; };
+struct LPC_GPDMA_TypeDef { volatile uint32_t DMACIntStat, DMACIntTCStat, DMACIntTCClear, DMACIntErrStat, DMACIntErrClr, DMACRawIntTCStat, DMACRawIntErrStat, DMACEnbldChns, DMACSoftBReq, DMACSoftSReq, DMACSoftLBReq, DMACSoftLSReq, DMACConfig, DMACSync; };
+struct LPC_GPDMACH_TypeDef { volatile uint32_t DMACCSrcAddr, DMACCDestAddr, DMACCLLI, DMACCControl, DMACCConfig; };
+extern LPC_SC_TypeDef hostSC; // Defined by the test that uses them
+extern LPC_SSP_TypeDef hostSSP1;
+extern LPC_GPDMA_TypeDef hostGPDMA;
+extern LPC_GPDMACH_TypeDef hostGPDMACH7;
+#define LPC_SC (&hostSC)
+#define LPC_SSP1 (&hostSSP1)
+#define LPC_GPDMA (&hostGPDMA)
+#define LPC_GPDMACH7 (&hostGPDMACH7)
+
+enum IRQn_Type { DMA_IRQn = 26 };
+inline void NVIC_SetVector(IRQn_Type, uint32_t) {}
+inline void NVIC_EnableIRQ(IRQn_Type) {}
+
+#endif
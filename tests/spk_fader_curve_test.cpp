@@ -0,0 +1,111 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// Host test for SPKFaderCurve. Checks each shape compiles to the curve it should, and that the settings file's values compile or are refused as they should.
+// g++ -I tests -I . tests/spk_fader_curve_test.cpp -o fader_curve_test && ./fader_curve_test
+
+#include "mbed.h"
+#include "spk_fader_curve.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        printf("  failed: %s\n", what);
+        failures++;
+    }
+}
+
+static bool isMonotonic(SPKFaderCurve &curve)
+{
+    int32_t last = curve.apply(0);
+    for (int32_t position=1; position <= 65536; position++)
+    {
+        int32_t value = curve.apply(position);
+        if (value < last) return false;
+        last = value;
+    }
+    return true;
+}
+
+static bool isEqual(SPKFaderCurve &a, SPKFaderCurve &b)
+{
+    for (int32_t position=0; position <= 65536; position++) if (a.apply(position) != b.apply(position)) return false;
+    return true;
+}
+
+int main()
+{
+    SPKFaderCurve curve;
+
+    // Shapes
+    expect(curve.apply(0) == 0 && curve.apply(32768) == 32768 && curve.apply(65536) == 65536, "linear is the identity");
+    expect(curve.apply(-5) == 0 && curve.apply(70000) == 65536, "positions off the ends clamp");
+
+    curve.compileS();
+    expect(curve.apply(0) == 0 && curve.apply(32768) == 32768 && curve.apply(65536) == 65536, "S keeps the ends and middle");
+    expect(curve.apply(8192) < 8192 && curve.apply(57344) > 57344, "S is slow out of and into the ends");
+    expect(isMonotonic(curve), "S is monotonic");
+
+    curve.compileLog();
+    expect(curve.apply(0) == 0 && curve.apply(65536) == 65536, "log keeps the ends");
+    expect(curve.apply(6554) > 65536/4, "log is fast out of zero");
+    expect(isMonotonic(curve), "log is monotonic");
+
+    // A cut is a step at the threshold, with nothing in between
+    curve.compileCut(10);
+    expect(curve.apply(6553) == 0, "cut at 10% is off just below 10%");
+    expect(curve.apply(6554) == 65536, "cut at 10% is on from 10%");
+    expect(curve.apply(0) == 0 && curve.apply(65536) == 65536, "cut keeps the ends");
+
+    curve.compileCut(0);
+    expect(curve.apply(0) == 65536, "cut at 0% is always on");
+    curve.compileCut(100);
+    expect(curve.apply(65535) == 0 && curve.apply(65536) == 65536, "cut at 100% is only on at the end");
+
+    // Breakpoints
+    SPKFaderCurve cut;
+    cut.compileCut(10);
+    expect(curve.compilePoints("0:0, 10:0, 10:100, 100:100"), "step breakpoints compile");
+    expect(isEqual(curve, cut), "step breakpoints are the cut");
+
+    expect(curve.compilePoints("0:0, 50:20, 100:100"), "breakpoints compile");
+    expect(curve.apply(32768) == 13107, "breakpoints are exact at a point");
+    expect(curve.apply(16384) == 6553, "breakpoints are straight lines between");
+    expect(curve.apply(49152) == 39321, "breakpoints are straight lines between");
+    expect(isMonotonic(curve), "rising breakpoints are monotonic");
+
+    expect(curve.compilePoints("0:0,30:60,30:80,100:100"), "breakpoints without spaces compile");
+    expect(curve.apply(19660) < 39322 && curve.apply(19661) == 52429, "a step between slopes steps at its input");
+
+    SPKFaderCurve unchanged;
+    unchanged.compileS();
+    curve.compileS();
+    expect(!curve.compilePoints("0:0"), "a single breakpoint is refused");
+    expect(!curve.compilePoints("50:0, 10:100"), "descending breakpoints are refused");
+    expect(!curve.compilePoints("0:0, 100:101"), "breakpoints over 100% are refused");
+    expect(!curve.compilePoints("nonsense"), "text is refused");
+    expect(isEqual(curve, unchanged), "a refused curve is left as it was");
+
+    // As read from the settings file
+    expect(curve.setFader("XFade") && curve.fader == SPKFaderCurve::faderXFade, "fader XFade");
+    expect(curve.setFader("fadeup") && curve.fader == SPKFaderCurve::faderFadeUp, "fader FadeUp, any case");
+    expect(curve.setFader("Both") && curve.appliesTo(SPKFaderCurve::faderXFade) && curve.appliesTo(SPKFaderCurve::faderFadeUp), "fader Both");
+    expect(!curve.setFader("Left") && curve.fader == SPKFaderCurve::faderBoth, "an unknown fader is refused");
+
+    SPKFaderCurve s;
+    s.compileS();
+    expect(curve.compile("s", NULL, -1) && isEqual(curve, s), "shape S, any case");
+    expect(curve.compile("Cut", NULL, 10) && isEqual(curve, cut), "shape Cut with a threshold");
+    expect(!curve.compile("Cut", NULL, -1), "shape Cut without a threshold is refused");
+    expect(!curve.compile("Cut", NULL, 101), "shape Cut over 100% is refused");
+    expect(!curve.compile("Wiggle", NULL, -1), "an unknown shape is refused");
+    expect(curve.compile("Wiggle", "0:0, 10:0, 10:100, 100:100", -1) && isEqual(curve, cut), "points take precedence over the shape");
+    expect(curve.compile("Linear", NULL, -1) && curve.apply(12345) == 12345, "shape Linear");
+
+    printf(failures ? "FAILED\n" : "Passed\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// Host test for SPKMixEngine. Compares the whole percents with the float and double formulas it replaced, over every pair of positions.
+// Build with SSE floats, ie. any x86-64 compiler without -ffast-math, so float and double round as the LPC1768's soft-float library does.
+// g++ -O2 -I tests -I . tests/spk_mix_engine_test.cpp -o mix_engine_test && ./mix_engine_test
+// Additive is checked at every curve the menu can reach, over every 64th crossfade position.
+// Takes ten minutes or so. Pass a stride, ie. ./mix_engine_test 7, to check every 7th crossfade position only.
+
+#include "mbed.h"
+#include "spk_mix_engine.h"
+
+enum { modeBlend, modeAdditive, modeKeyLeft, modeKeyRight };
+
+// As main.cpp had them
+static void reference(int mode, float xFade, float fadeUp, float fadeCurve, int &fadeA, int &fadeB)
+{
+    double a = 0, b = 0;
+
+    if (mode == modeBlend)
+    {
+        if (xFade > 0)
+        {
+            a = (1.0-xFade) * fadeUp * 100.0;
+            b = (xFade*fadeUp) / (1.0 - fadeUp + xFade*fadeUp) * 100.0;
+        }
+        else
+        {
+            a = fadeUp * 100.0;
+            b = 0;
+        }
+    }
+    else if (mode == modeAdditive)
+    {
+        float newFadeA = (1.0-xFade) * (1.0 + fadeCurve);
+        float newFadeB = xFade * (1 + fadeCurve);
+        if (newFadeA > 1.0) newFadeA = 1.0;
+        if (newFadeB > 1.0) newFadeB = 1.0;
+        a = newFadeA * fadeUp * 100.0;
+        b = newFadeB * fadeUp * 100.0;
+    }
+    else if (mode == modeKeyLeft)
+    {
+        a = (1.0-xFade) * fadeUp * 100.0;
+        b = fadeUp * 100.0;
+    }
+    else
+    {
+        a = fadeUp * 100.0;
+        b = xFade * fadeUp * 100.0;
+    }
+
+    fadeA = int(a);
+    fadeB = int(b);
+}
+
+static long check(SPKMixEngine &engine, int mode, float fadeCurve, int xStride)
+{
+    long failures = 0;
+
+    for (int i=0; i*xStride < 65536 + xStride; i++)
+    {
+        // Always including the end
+        int x = (i*xStride < 65536) ? i*xStride : 65536;
+
+        for (int f=0; f <= 65536; f++)
+        {
+            int refA, refB;
+            reference(mode, x/65536.0f, f/65536.0f, fadeCurve, refA, refB);
+
+            int32_t a, b;
+            switch (mode)
+            {
+                case modeBlend:     engine.blend(x, f, a, b);       break;
+                case modeAdditive:  engine.additive(x, f, a, b);    break;
+                case modeKeyLeft:   engine.keyLeft(x, f, a, b);     break;
+                default:            engine.keyRight(x, f, a, b);
+            }
+
+            if ((a >> 16) != refA || (b >> 16) != refB)
+            {
+                if (failures < 5) printf("  mode %i curve %.9g xFade %i fadeUp %i: expected %i %i, got %i %i\n", mode, fadeCurve, x, f, refA, refB, a >> 16, b >> 16);
+                failures++;
+            }
+        }
+    }
+
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    int stride = (argc > 1) ? atoi(argv[1]) : 1;
+    if (stride < 1) stride = 1;
+
+    SPKMixEngine engine;
+    long failures = 0;
+
+    const char *names[] = {"blend", "additive", "key left", "key right"};
+    const int modes[] = {modeBlend, modeKeyLeft, modeKeyRight};
+    for (int i=0; i < 3; i++)
+    {
+        long modeFailures = check(engine, modes[i], 0.0f, stride);
+        printf("%s: %li failures\n", names[modes[i]], modeFailures);
+        failures += modeFailures;
+    }
+
+    // Every curve the menu can reach, a 0.05f step at a time up from 0 and down from 1
+    for (int direction=0; direction < 2; direction++)
+    {
+        float fadeCurve = direction ? 1.0f : 0.0f;
+        for (int step=0; step <= 20; step++)
+        {
+            if (fadeCurve > 0.001f)
+            {
+                engine.setFadeCurve(fadeCurve);
+                long curveFailures = check(engine, modeAdditive, fadeCurve, stride * 64);
+                if (curveFailures) printf("additive at %.9g: %li failures\n", fadeCurve, curveFailures);
+                failures += curveFailures;
+            }
+
+            fadeCurve += direction ? -0.05f : 0.05f;
+            if (fadeCurve > 1.0f) fadeCurve = 1.0f;
+            if (fadeCurve < 0.0f) fadeCurve = 0.0f;
+        }
+    }
+    printf("additive: checked menu curves\n");
+
+    printf(failures ? "FAILED\n" : "Passed\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+// *SPARK D-FUSER
+// A project by Toby Harris
+// Copyright *spark audio-visual 2012
+//
+// Host test for SPKDisplay's text. Checks the packed font against the per-character glyphs it was generated from,
+// and that text and labels render to the same columns as drawing those glyphs one character at a time did.
+// -Wno-cpp for the driver's warning that its setup values are unchecked, which doesn't apply to drawing.
+// g++ -Wall -Werror -Wno-cpp -I tests -I . tests/spk_oled_gfx_test.cpp -o oled_gfx_test && ./oled_gfx_test
+
+#include "mbed.h"
+
+// The framebuffer is private
+#define private public
+#include "spk_oled_ssd1305.h"
+#undef private
+#include "spk_oled_gfx.h"
+
+LPC_SC_TypeDef hostSC;
+LPC_SSP_TypeDef hostSSP1;
+LPC_GPDMA_TypeDef hostGPDMA;
+LPC_GPDMACH_TypeDef hostGPDMACH7;
+
+// As spk_oled_gfx.h had them: number of columns, column0 hex, column1 hex...
+static const uint8_t oldChar33[] = {1, 0x2F};
+static const uint8_t oldChar34[] = {1, 0x06};
+static const uint8_t oldChar35[] = {5, 0x14, 0x3E, 0x14, 0x3E, 0x14};
+static const uint8_t oldChar36[] = {5, 0x24, 0x2A, 0x7F, 0x2A, 0x12};
+static const uint8_t oldChar37[] = {5, 0x06, 0x36, 0x08, 0x36, 0x30};
+static const uint8_t oldChar38[] = {6, 0x14, 0x2A, 0x2A, 0x24, 0x10, 0x08};
+static const uint8_t oldChar39[] = {1, 0x06};
+static const uint8_t oldChar40[] = {2, 0x3E, 0x41};
+static const uint8_t oldChar41[] = {2, 0x41, 0x3E};
+static const uint8_t oldChar42[] = {5, 0x14, 0x08, 0x3E, 0x08, 0x14};
+static const uint8_t oldChar43[] = {5, 0x08, 0x08, 0x3E, 0x08, 0x08};
+static const uint8_t oldChar44[] = {2, 0x40, 0x20};
+static const uint8_t oldChar45[] = {3, 0x08, 0x08, 0x08};
+static const uint8_t oldChar46[] = {1, 0x20};
+static const uint8_t oldChar47[] = {3, 0x30, 0x08, 0x06};
+static const uint8_t oldChar48[] = {5, 0x1C, 0x22, 0x2A, 0x22, 0x1C};
+static const uint8_t oldChar49[] = {3, 0x22, 0x3E, 0x20};
+static const uint8_t oldChar50[] = {5, 0x32, 0x2A, 0x2A, 0x2A, 0x24};
+static const uint8_t oldChar51[] = {5, 0x22, 0x2A, 0x2A, 0x2A, 0x14};
+static const uint8_t oldChar52[] = {5, 0x18, 0x14, 0x12, 0x3E, 0x10};
+static const uint8_t oldChar53[] = {5, 0x2E, 0x2A, 0x2A, 0x2A, 0x12};
+static const uint8_t oldChar54[] = {5, 0x1C, 0x2A, 0x2A, 0x2A, 0x10};
+static const uint8_t oldChar55[] = {4, 0x02, 0x32, 0x0A, 0x06};
+static const uint8_t oldChar56[] = {5, 0x14, 0x2A, 0x2A, 0x2A, 0x14};
+static const uint8_t oldChar57[] = {5, 0x04, 0x2A, 0x2A, 0x2A, 0x1C};
+static const uint8_t oldChar58[] = {1, 0x24};
+static const uint8_t oldChar59[] = {2, 0x40, 0x24};
+static const uint8_t oldChar60[] = {3, 0x08, 0x14, 0x22};
+static const uint8_t oldChar61[] = {4, 0x14, 0x14, 0x14, 0x14};
+static const uint8_t oldChar62[] = {3, 0x22, 0x14, 0x08};
+static const uint8_t oldChar63[] = {4, 0x01, 0x2D, 0x05, 0x02};
+static const uint8_t oldChar64[] = {6, 0x3E, 0x41, 0x4D, 0x55, 0x15, 0x1E};
+static const uint8_t oldChar65[] = {5, 0x3C, 0x0A, 0x0A, 0x0A, 0x3C};
+static const uint8_t oldChar66[] = {5, 0x3E, 0x2A, 0x2A, 0x2A, 0x14};
+static const uint8_t oldChar67[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x14};
+static const uint8_t oldChar68[] = {5, 0x3E, 0x22, 0x22, 0x22, 0x1C};
+static const uint8_t oldChar69[] = {4, 0x3E, 0x2A, 0x2A, 0x22};
+static const uint8_t oldChar70[] = {4, 0x3E, 0x0A, 0x0A, 0x02};
+static const uint8_t oldChar71[] = {5, 0x1C, 0x22, 0x22, 0x2A, 0x1A};
+static const uint8_t oldChar72[] = {5, 0x3E, 0x08, 0x08, 0x08, 0x3E};
+static const uint8_t oldChar73[] = {1, 0x3E};
+static const uint8_t oldChar74[] = {5, 0x10, 0x20, 0x20, 0x20, 0x1E};
+static const uint8_t oldChar75[] = {5, 0x3E, 0x08, 0x08, 0x14, 0x22};
+static const uint8_t oldChar76[] = {4, 0x3E, 0x20, 0x20, 0x20};
+static const uint8_t oldChar77[] = {5, 0x3E, 0x04, 0x08, 0x04, 0x3E};
+static const uint8_t oldChar78[] = {5, 0x3E, 0x04, 0x08, 0x10, 0x3E};
+static const uint8_t oldChar79[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x1C};
+static const uint8_t oldChar80[] = {5, 0x3E, 0x0A, 0x0A, 0x0A, 0x04};
+static const uint8_t oldChar81[] = {5, 0x1C, 0x22, 0x72, 0xA2, 0x1C};
+static const uint8_t oldChar82[] = {5, 0x3E, 0x0A, 0x0A, 0x1A, 0x24};
+static const uint8_t oldChar83[] = {5, 0x24, 0x2A, 0x2A, 0x2A, 0x12};
+static const uint8_t oldChar84[] = {5, 0x02, 0x02, 0x3E, 0x02, 0x02};
+static const uint8_t oldChar85[] = {5, 0x1E, 0x20, 0x20, 0x20, 0x1E};
+static const uint8_t oldChar86[] = {5, 0x06, 0x18, 0x20, 0x18, 0x06};
+static const uint8_t oldChar87[] = {7, 0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E};
+static const uint8_t oldChar88[] = {5, 0x22, 0x14, 0x08, 0x14, 0x22};
+static const uint8_t oldChar89[] = {5, 0x02, 0x04, 0x38, 0x04, 0x02};
+static const uint8_t oldChar90[] = {5, 0x22, 0x32, 0x2A, 0x26, 0x22};
+static const uint8_t oldChar91[] = {2, 0x7F, 0x41};
+static const uint8_t oldChar92[] = {3, 0x06, 0x08, 0x30};
+static const uint8_t oldChar93[] = {2, 0x41, 0x7F};
+static const uint8_t oldChar94[] = {3, 0x04, 0x02, 0x04};
+static const uint8_t oldChar95[] = {4, 0x40, 0x40, 0x40, 0x40};
+static const uint8_t oldChar96[] = {2, 0x02, 0x04};
+static const uint8_t oldChar97[] = {5, 0x3C, 0x0A, 0x0A, 0x0A, 0x3C};
+static const uint8_t oldChar98[] = {5, 0x3E, 0x2A, 0x2A, 0x2A, 0x14};
+static const uint8_t oldChar99[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x14};
+static const uint8_t oldChar100[] = {5, 0x3E, 0x22, 0x22, 0x22, 0x1C};
+static const uint8_t oldChar101[] = {4, 0x1C, 0x2A, 0x2A, 0x22};
+static const uint8_t oldChar102[] = {4, 0x3E, 0x0A, 0x0A, 0x02};
+static const uint8_t oldChar103[] = {5, 0x1C, 0xA2, 0xA2, 0xAA, 0x7A};
+static const uint8_t oldChar104[] = {5, 0x3E, 0x08, 0x08, 0x08, 0x3E};
+static const uint8_t oldChar105[] = {1, 0x3A};
+static const uint8_t oldChar106[] = {5, 0x10, 0x20, 0x22, 0x22, 0x1E};
+static const uint8_t oldChar107[] = {5, 0x3E, 0x08, 0x08, 0x14, 0x22};
+static const uint8_t oldChar108[] = {4, 0x3E, 0x20, 0x20, 0x20};
+static const uint8_t oldChar109[] = {5, 0x3E, 0x04, 0x08, 0x04, 0x3E};
+static const uint8_t oldChar110[] = {5, 0x3E, 0x04, 0x08, 0x10, 0x3E};
+static const uint8_t oldChar111[] = {5, 0x1C, 0x22, 0x22, 0x22, 0x1C};
+static const uint8_t oldChar112[] = {5, 0x3E, 0x0A, 0x0A, 0x0A, 0x04};
+static const uint8_t oldChar113[] = {5, 0x1C, 0x22, 0x72, 0xA2, 0x1C};
+static const uint8_t oldChar114[] = {5, 0x3E, 0x0A, 0x0A, 0x1A, 0x24};
+static const uint8_t oldChar115[] = {5, 0x24, 0x2A, 0x2A, 0x2A, 0x12};
+static const uint8_t oldChar116[] = {5, 0x02, 0x02, 0x3E, 0x02, 0x02};
+static const uint8_t oldChar117[] = {5, 0x1E, 0x20, 0x20, 0x20, 0x1E};
+static const uint8_t oldChar118[] = {5, 0x06, 0x18, 0x20, 0x18, 0x06};
+static const uint8_t oldChar119[] = {7, 0x1E, 0x20, 0x10, 0x0E, 0x10, 0x20, 0x1E};
+static const uint8_t oldChar120[] = {5, 0x22, 0x14, 0x08, 0x14, 0x22};
+static const uint8_t oldChar121[] = {5, 0x02, 0x04, 0x38, 0x04, 0x02};
+static const uint8_t oldChar122[] = {5, 0x22, 0x32, 0x2A, 0x26, 0x22};
+static const uint8_t oldChar123[] = {3, 0x08, 0x77, 0x41};
+static const uint8_t oldChar124[] = {1, 0x3E};
+static const uint8_t oldChar125[] = {3, 0x41, 0x77, 0x08};
+static const uint8_t oldChar126[] = {4, 0x04, 0x02, 0x04, 0x02};
+
+static const uint8_t* oldCharacters[] = {oldChar33, oldChar34, oldChar35, oldChar36, oldChar37, oldChar38, oldChar39, oldChar40, oldChar41, oldChar42, oldChar43, oldChar44, oldChar45, oldChar46, oldChar47, oldChar48, oldChar49, oldChar50, oldChar51, oldChar52, oldChar53, oldChar54, oldChar55, oldChar56, oldChar57, oldChar58, oldChar59, oldChar60, oldChar61, oldChar62, oldChar63, oldChar64, oldChar65, oldChar66, oldChar67, oldChar68, oldChar69, oldChar70, oldChar71, oldChar72, oldChar73, oldChar74, oldChar75, oldChar76, oldChar77, oldChar78, oldChar79, oldChar80, oldChar81, oldChar82, oldChar83, oldChar84, oldChar85, oldChar86, oldChar87, oldChar88, oldChar89, oldChar90, oldChar91, oldChar92, oldChar93, oldChar94, oldChar95, oldChar96, oldChar97, oldChar98, oldChar99, oldChar100, oldChar101, oldChar102, oldChar103, oldChar104, oldChar105, oldChar106, oldChar107, oldChar108, oldChar109, oldChar110, oldChar111, oldChar112, oldChar113, oldChar114, oldChar115, oldChar116, oldChar117, oldChar118, oldChar119, oldChar120, oldChar121, oldChar122, oldChar123, oldChar124, oldChar125, oldChar126};
+
+static int failures = 0;
+
+static void expect(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        printf("  failed: %s\n", what);
+        failures++;
+    }
+}
+
+// As textToBuffer() had it, into a cleared row
+static void oldTextToRow(const std::string &message, uint8_t *row)
+{
+    memset(row, 0, 128);
+
+    int x = 0;
+    for (size_t i=0; i < message.length() && x < 128; i++)
+    {
+        char character = message[i];
+        if (character < 33 || character > 126)
+        {
+            x += kSPKDisplaySpaceWidth + 1;
+            continue;
+        }
+
+        const uint8_t *glyph = oldCharacters[character - 33];
+        int width = glyph[0];
+        if (x + width > 128) width = 128 - x;
+        memcpy(row + x, glyph + 1, width);
+        x += glyph[0] + 1;
+    }
+}
+
+static void expectText(SPKDisplay &display, const std::string &message, int row)
+{
+    uint8_t expected[128];
+    oldTextToRow(message, expected);
+
+    display.clearBufferRow(row);
+    display.textToBuffer(message, row);
+    bool textOK = memcmp(display.buffer + row*128, expected, 128) == 0;
+
+    display.clearBufferRow(row);
+    display.labelToBuffer(message, row);
+    bool labelOK = memcmp(display.buffer + row*128, expected, 128) == 0;
+
+    if (!textOK || !labelOK) printf("  \"%s\" on row %d\n", message.c_str(), row);
+    expect(textOK, "text renders as the per-character glyphs did");
+    expect(labelOK, "label renders as the per-character glyphs did");
+}
+
+int main()
+{
+    SPKDisplay display(NC, NC, NC, NC, NC);
+    display.fontStartCharacter = &fontStartChar;
+    display.fontEndCharacter = &fontEndChar;
+    display.fontOffsets = fontOffsets;
+    display.fontColumns = fontColumns;
+
+    // The packed font is the glyphs end to end
+    expect(fontStartChar == 33 && fontEndChar == 126, "font covers the same characters");
+    bool packedOK = true;
+    for (int character=fontStartChar; character <= fontEndChar; character++)
+    {
+        const uint8_t *glyph = oldCharacters[character - 33];
+        int start = fontOffsets[character - fontStartChar];
+        int width = fontOffsets[character - fontStartChar + 1] - start;
+        if (width != glyph[0] || memcmp(fontColumns + start, glyph + 1, width)) packedOK = false;
+    }
+    expect(packedOK, "every packed character matches its glyph");
+    expect(fontOffsets[fontEndChar - fontStartChar + 1] == sizeof(fontColumns), "offsets end at the end of the columns");
+
+    // Every character alone, and every pair
+    for (int a=32; a <= 127; a++)
+    {
+        expectText(display, std::string(1, char(a)), a % 8);
+        for (int b=32; b <= 127; b++) expectText(display, std::string(1, char(a)) + char(b), b % 8);
+    }
+
+    // Strings as the menus draw them, and ones that run off the right of the row at every offset
+    expectText(display, "Blend [ ----- ] Add", 0);
+    expectText(display, "Set: [Fit/    /   /      ]", 1);
+    expectText(display, "Follow instructions... [+]", 2);
+    expectText(display, "", 3);
+    std::string everything;
+    for (int character=32; character <= 127; character++) everything += char(character);
+    for (size_t i=0; i < everything.length(); i++) expectText(display, everything.substr(i), i % 8);
+    expectText(display, "\tWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW", 7);
+
+    // Labels evicted and drawn again, more of them than the cache holds
+    for (int pass=0; pass < 3; pass++)
+    {
+        for (int i=0; i < kSPKDisplayLabelCacheSize * 2; i++)
+        {
+            char label[32];
+            snprintf(label, sizeof(label), "Label %d of %d", i, kSPKDisplayLabelCacheSize * 2);
+            expectText(display, label, i % 8);
+            if (i % 3 == 0) expectText(display, "Blend [ ----- ] Add", 0);
+        }
+    }
+
+    // A character on its own, clipped at the right
+    uint8_t expected[128];
+    oldTextToRow("W", expected);
+    display.clearBufferRow(5);
+    int taken = display.characterToBuffer('W', 125, 5);
+    expect(taken == oldCharacters['W' - 33][0] + 1, "a character takes its width and a gap");
+    expect(memcmp(display.buffer + 5*128 + 125, expected, 3) == 0, "a character is clipped at the right of the row");
+    expect(display.characterToBuffer(' ', 0, 5) == kSPKDisplaySpaceWidth + 1, "a space takes the space width and a gap");
+
+    printf(failures ? "FAILED\n" : "Passed\n");
+    return failures ? 1 : 0;
+}